@@ -88,29 +88,24 @@ GNM_PLUGIN_MODULE_HEADER;
 
 /**
  * find_cells_that_match :
- * Finds the cells from the given column that match the criteria.
+ * Finds the cells of the given column in the matching rows.
  */
 
-#warning  We should really be using find_rows_that_match from value.c
-
 static GSList *
 find_cells_that_match (Sheet *sheet, GnmValue const *database,
-		       int col, GSList *criterias)
+		       int col, GArray const *rows)
 {
-	GSList *ptr, *condition, *cells;
-	int    row, first_row, last_row;
-	gboolean add_flag;
+	GSList *cells;
 	GnmCell *cell;
 	int fake_col;
-	GnmValue const *empty = value_new_empty ();
+	unsigned ui;
 
 	cells = NULL;
-	/* TODO : Why ignore the first row ?  What if there is no header ? */
-	first_row = database->v_range.cell.a.row + 1;
-	last_row  = database->v_range.cell.b.row;
 	fake_col = database->v_range.cell.a.col;
 
-	for (row = first_row; row <= last_row; row++) {
+	for (ui = 0; ui < rows->len; ui++) {
+		int row = g_array_index (rows, int, ui);
+
 		cell = (col == -1)
 			? sheet_cell_fetch (sheet, fake_col, row)
 			: sheet_cell_get (sheet, col, row);
@@ -121,30 +116,7 @@ find_cells_that_match (Sheet *sheet, GnmValue const *database,
 		if (col != -1 && gnm_cell_is_empty (cell))
 			continue;
 
-		add_flag = TRUE;
-		for (ptr = criterias; ptr != NULL; ptr = ptr->next) {
-			GnmDBCriteria const *current_criteria = ptr->data;
-
-			add_flag = TRUE;
-			condition = current_criteria->conditions;
-
-			for (;condition != NULL ; condition = condition->next) {
-				GnmCriteria *cond = condition->data;
-				GnmCell *tmp = sheet_cell_get (sheet,
-					cond->column, row);
-				if (tmp != NULL)
-					gnm_cell_eval (tmp);
-				if (!cond->fun (tmp ? tmp->value : empty, cond)) {
-					add_flag = FALSE;
-					break;
-				}
-			}
-
-			if (add_flag)
-				break;
-		}
-		if (add_flag)
-			cells = g_slist_prepend (cells, cell);
+		cells = g_slist_prepend (cells, cell);
 	}
 
 	return g_slist_reverse (cells);
@@ -152,7 +124,7 @@ find_cells_that_match (Sheet *sheet, GnmValue const *database,
 
 static void *
 database_find_values (Sheet *sheet, GnmValue const *database,
-		      int col, GSList *criterias,
+		      int col, GArray const *rows,
 		      CollectFlags flags,
 		      int *pcount,
 		      GnmValue **error,
@@ -174,7 +146,7 @@ database_find_values (Sheet *sheet, GnmValue const *database,
 	*error = NULL;
 
 	/* FIXME: expand and sanitise this call later.  */
-	cells = find_cells_that_match (sheet, database, col, criterias);
+	cells = find_cells_that_match (sheet, database, col, rows);
 	cellcount = g_slist_length (cells);
 
 	/* Allocate memory -- one extra to make sure we don't get NULL.  */
@@ -226,7 +198,7 @@ database_float_range_function (GnmFuncEvalInfo *ei,
 			       GnmStdError func_error)
 {
 	int fieldno;
-	GSList *criterias = NULL;
+	GArray *rows = NULL;
 	Sheet *sheet;
 	int count;
 	int err;
@@ -243,14 +215,14 @@ database_float_range_function (GnmFuncEvalInfo *ei,
 	    !VALUE_IS_CELLRANGE (database))
 		return value_new_error_NUM (ei->pos);
 
-	criterias = parse_database_criteria (ei->pos, database, criteria);
-	if (criterias == NULL)
+	rows = gnm_database_matching_rows (ei->pos, database, criteria);
+	if (rows == NULL)
 		return value_new_error_NUM (ei->pos);
 
 	sheet = eval_sheet (database->v_range.cell.a.sheet,
 			    ei->pos->sheet);
 
-	vals = database_find_values (sheet, database, fieldno, criterias,
+	vals = database_find_values (sheet, database, fieldno, rows,
 				     flags, &count, &res, TRUE);
 
 	if (!vals) {
@@ -269,8 +241,7 @@ database_float_range_function (GnmFuncEvalInfo *ei,
 		res = value_new_float (fres);
 
  out:
-	if (criterias)
-		free_criterias (criterias);
+	g_array_unref (rows);
 	g_free (vals);
 	return res;
 }
@@ -291,7 +262,7 @@ database_value_range_function (GnmFuncEvalInfo *ei,
 			       gboolean allow_missing_field)
 {
 	int fieldno;
-	GSList *criterias = NULL;
+	GArray *rows = NULL;
 	Sheet *sheet;
 	int count;
 	int err;
@@ -312,14 +283,14 @@ database_value_range_function (GnmFuncEvalInfo *ei,
 			return value_new_error_NUM (ei->pos);
 	}
 
-	criterias = parse_database_criteria (ei->pos, database, criteria);
-	if (criterias == NULL)
+	rows = gnm_database_matching_rows (ei->pos, database, criteria);
+	if (rows == NULL)
 		return value_new_error_NUM (ei->pos);
 
 	sheet = eval_sheet (database->v_range.cell.a.sheet,
 			    ei->pos->sheet);
 
-	vals = database_find_values (sheet, database, fieldno, criterias,
+	vals = database_find_values (sheet, database, fieldno, rows,
 				     flags, &count, &res, FALSE);
 
 	if (!vals) {
@@ -336,8 +307,7 @@ database_value_range_function (GnmFuncEvalInfo *ei,
 		res = value_new_error_std (ei->pos, func_error);
 
  out:
-	if (criterias)
-		free_criterias (criterias);
+	g_array_unref (rows);
 	g_free (vals);
 	return res;
 }
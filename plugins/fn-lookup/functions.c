@@ -59,6 +59,7 @@ typedef struct {
 		const char *str;
 		gnm_float f;
 	} u;
+	const char *ckey;	/* Collation key of str */
 } LookupBisectionCacheItemElem;
 
 typedef struct {
@@ -78,7 +79,7 @@ bisection_compare_string (const void *a_, const void *b_)
 {
 	const LookupBisectionCacheItemElem *a = a_;
 	const LookupBisectionCacheItemElem *b = b_;
-	return g_utf8_collate (a->u.str, b->u.str);
+	return strcmp (a->ckey, b->ckey);
 }
 
 static int
@@ -539,7 +540,6 @@ find_index_linear_equal_string (GnmFuncEvalInfo *ei,
 {
 	GHashTable *h;
 	gpointer pres;
-	char *sc;
 	gboolean found;
 	LinearLookupInfo info;
 
@@ -555,18 +555,17 @@ find_index_linear_equal_string (GnmFuncEvalInfo *ei,
 
 		for (lp = 0; lp < length; lp++) {
 			GnmValue const *v = get_elem (data, lp, ei->pos, vertical);
-			char *vc;
+			char const *vc;
 
 			if (!find_compare_type_valid (find, v))
 				continue;
 
-			vc = g_utf8_casefold (value_peek_string (v), -1);
+			/* The case fold is cached on the shared string.  */
+			vc = go_string_get_casefold (v->v_str.val);
 			if (!g_hash_table_lookup_extended (h, vc, NULL, NULL)) {
 				char *sc = g_string_chunk_insert (lookup_string_pool, vc);
 				g_hash_table_insert (h, sc, GINT_TO_POINTER (lp));
 			}
-
-			g_free (vc);
 		}
 
 		linear_lookup_cache_commit (&info);
@@ -574,9 +573,8 @@ find_index_linear_equal_string (GnmFuncEvalInfo *ei,
 		protect_string_pool--;
 	}
 
-	sc = g_utf8_casefold (value_peek_string (find), -1);
-	found = g_hash_table_lookup_extended (h, sc, NULL, &pres);
-	g_free (sc);
+	found = g_hash_table_lookup_extended
+		(h, go_string_get_casefold (find->v_str.val), NULL, &pres);
 
 	return found ? GPOINTER_TO_INT (pres) : LOOKUP_NOT_THERE;
 }
@@ -708,9 +706,13 @@ find_index_bisection (GnmFuncEvalInfo *ei,
 				continue;
 
 			if (stringp) {
-				char *vc = g_utf8_casefold (value_peek_string (v), -1);
-				bc->data[bc->n].u.str = g_string_chunk_insert (lookup_string_pool, vc);
-				g_free (vc);
+				GOString const *gs = v->v_str.val;
+				bc->data[bc->n].u.str = g_string_chunk_insert
+					(lookup_string_pool,
+					 go_string_get_casefold (gs));
+				bc->data[bc->n].ckey = g_string_chunk_insert
+					(lookup_string_pool,
+					 go_string_get_casefolded_collate (gs));
 			} else
 				bc->data[bc->n].u.f = value_get_as_float (v);
 
@@ -735,9 +737,9 @@ find_index_bisection (GnmFuncEvalInfo *ei,
 		return wildcard_string_match (value_peek_string (find), bc);
 
 	if (stringp) {
-		char *vc = g_utf8_casefold (value_peek_string (find), -1);
-		key.u.str = g_string_chunk_insert (lookup_string_pool, vc);
-		g_free (vc);
+		/* Cached on the shared string; no need to pool these.  */
+		key.u.str = go_string_get_casefold (find->v_str.val);
+		key.ckey = go_string_get_casefolded_collate (find->v_str.val);
 	} else {
 #ifdef DEBUG_BISECTION
 		int lp;
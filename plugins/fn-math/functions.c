@@ -967,6 +967,14 @@ gnumeric_exp (GnmFuncEvalInfo *ei, GnmValue const * const *argv)
 	return value_new_float (gnm_exp (value_get_as_float (argv[0])));
 }
 
+static gboolean
+gnumeric_exp_vector (GnmFunc *func, GnmFuncEvalInfo *ei,
+		     gnm_float *xs, int n, gpointer data)
+{
+	gnm_exp_vec (xs, n);
+	return TRUE;
+}
+
 static GnmExpr const *
 gnumeric_exp_deriv (GnmFunc *func, GnmExpr const *expr, GnmEvalPos const *ep,
 		    GnmExprDeriv *info)
@@ -1056,6 +1064,22 @@ gnumeric_gammaln (GnmFuncEvalInfo *ei, GnmValue const * const *argv)
 		return value_new_float (gnm_lgamma (x));
 }
 
+static gboolean
+gnumeric_gammaln_vector (GnmFunc *func, GnmFuncEvalInfo *ei,
+			 gnm_float *xs, int n, gpointer data)
+{
+	int i;
+
+	for (i = 0; i < n; i++) {
+		gnm_float x = xs[i];
+		if (x < 0 && (x == gnm_floor (x) ||
+			      gnm_fmod (gnm_floor (-x), 2.0) == 0.0))
+			xs[i] = gnm_nan;
+	}
+	lgamma_vec (xs, n);
+	return TRUE;
+}
+
 /***************************************************************************/
 
 static GnmFuncHelp const help_digamma[] = {
@@ -1357,6 +1381,19 @@ gnumeric_ln (GnmFuncEvalInfo *ei, GnmValue const * const *argv)
 	return value_new_float (gnm_log (t));
 }
 
+static gboolean
+gnumeric_ln_vector (GnmFunc *func, GnmFuncEvalInfo *ei,
+		    gnm_float *xs, int n, gpointer data)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		if (xs[i] <= 0)
+			xs[i] = gnm_nan;
+	gnm_log_vec (xs, n);
+	return TRUE;
+}
+
 static GnmExpr const *
 gnumeric_ln_deriv (GnmFunc *func,
 		   GnmExpr const *expr, GnmEvalPos const *ep,
@@ -3812,6 +3849,13 @@ go_plugin_init (GOPlugin *plugin, GOCmdContext *cc)
 			  "derivative", G_CALLBACK (gnumeric_exp_deriv), NULL);
 	g_signal_connect (gnm_func_lookup ("ln", NULL),
 			  "derivative", G_CALLBACK (gnumeric_ln_deriv), NULL);
+
+	g_signal_connect (gnm_func_lookup ("exp", NULL),
+			  "eval-vector", G_CALLBACK (gnumeric_exp_vector), NULL);
+	g_signal_connect (gnm_func_lookup ("ln", NULL),
+			  "eval-vector", G_CALLBACK (gnumeric_ln_vector), NULL);
+	g_signal_connect (gnm_func_lookup ("gammaln", NULL),
+			  "eval-vector", G_CALLBACK (gnumeric_gammaln_vector), NULL);
 }
 
 G_MODULE_EXPORT void
@@ -153,6 +153,42 @@ gnumeric_stdevp (GnmFuncEvalInfo *ei, int argc, GnmExprConstPtr const *argv)
 
 /***************************************************************************/
 
+/*
+ * The number of values in the sorted xs that are less than x and that are
+ * not greater than x, respectively.
+ */
+static int
+sorted_count_less (gnm_float const *xs, int n, gnm_float x)
+{
+	int lo = 0, hi = n;
+
+	while (lo < hi) {
+		int mid = lo + (hi - lo) / 2;
+		if (xs[mid] < x)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+static int
+sorted_count_not_greater (gnm_float const *xs, int n, gnm_float x)
+{
+	int lo = 0, hi = n;
+
+	while (lo < hi) {
+		int mid = lo + (hi - lo) / 2;
+		if (xs[mid] <= x)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+/***************************************************************************/
+
 static GnmFuncHelp const help_rank[] = {
 	{ GNM_FUNC_HELP_NAME, F_("RANK:rank of a number in a list of numbers")},
 	{ GNM_FUNC_HELP_ARG, F_("x:number whose rank you want to find")},
@@ -171,34 +207,34 @@ static GnmValue *
 gnumeric_rank (GnmFuncEvalInfo *ei, GnmValue const * const *argv)
 {
 	gnm_float *xs;
-	int i, r, n;
+	int r, n;
 	GnmValue *result = NULL;
 	gnm_float x;
-	gboolean increasing;
+	gboolean increasing, constp;
 
+	/* The sorted data is shared by all RANK calls on the same range.  */
 	x = value_get_as_float (argv[0]);
-	xs = collect_floats_value (argv[1], ei->pos,
-				   COLLECT_IGNORE_STRINGS |
-				   COLLECT_IGNORE_BOOLS |
-				   COLLECT_IGNORE_BLANKS |
-				   COLLECT_ORDER_IRRELEVANT,
-				   &n, &result);
+	xs = collect_floats_value_shared (argv[1], ei->pos,
+					  COLLECT_IGNORE_STRINGS |
+					  COLLECT_IGNORE_BOOLS |
+					  COLLECT_IGNORE_BLANKS |
+					  COLLECT_SORT,
+					  &n, &result, &constp);
 	increasing = argv[2] ? value_get_as_checked_bool (argv[2]) : FALSE;
 
 	if (result)
 		goto out;
 
-	for (i = 0, r = 1; i < n; i++) {
-		gnm_float y = xs[i];
-
-		if (increasing ? y < x : y > x)
-			r++;
-	}
+	if (increasing)
+		r = 1 + sorted_count_less (xs, n, x);
+	else
+		r = 1 + (n - sorted_count_not_greater (xs, n, x));
 
 	result = value_new_int (r);
 
  out:
-	g_free (xs);
+	if (!constp)
+		g_free (xs);
 
 	return result;
 }
@@ -223,31 +259,27 @@ static GnmValue *
 gnumeric_rank_avg (GnmFuncEvalInfo *ei, GnmValue const * const *argv)
 {
 	gnm_float *xs;
-	int i, r, n, t;
+	int r, n, t, less, not_greater;
 	GnmValue *result = NULL;
 	gnm_float x;
-	gboolean increasing;
+	gboolean increasing, constp;
 
 	x = value_get_as_float (argv[0]);
-	xs = collect_floats_value (argv[1], ei->pos,
-				   COLLECT_IGNORE_STRINGS |
-				   COLLECT_IGNORE_BOOLS |
-				   COLLECT_IGNORE_BLANKS |
-				   COLLECT_ORDER_IRRELEVANT,
-				   &n, &result);
+	xs = collect_floats_value_shared (argv[1], ei->pos,
+					  COLLECT_IGNORE_STRINGS |
+					  COLLECT_IGNORE_BOOLS |
+					  COLLECT_IGNORE_BLANKS |
+					  COLLECT_SORT,
+					  &n, &result, &constp);
 	increasing = argv[2] ? value_get_as_checked_bool (argv[2]) : FALSE;
 
 	if (result)
 		goto out;
 
-	for (i = 0, r = 1, t = 0; i < n; i++) {
-		gnm_float y = xs[i];
-
-		if (increasing ? y < x : y > x)
-			r++;
-		if (x == y)
-			t++;
-	}
+	less = sorted_count_less (xs, n, x);
+	not_greater = sorted_count_not_greater (xs, n, x);
+	r = 1 + (increasing ? less : n - not_greater);
+	t = not_greater - less;
 
 	if (t > 1)
 		result = value_new_float (r + (t - 1)/2.);
@@ -255,7 +287,8 @@ gnumeric_rank_avg (GnmFuncEvalInfo *ei, GnmValue const * const *argv)
 		result = value_new_int (r);
 
  out:
-	g_free (xs);
+	if (!constp)
+		g_free (xs);
 
 	return result;
 }
@@ -451,6 +484,14 @@ gnumeric_normsdist (GnmFuncEvalInfo *ei, GnmValue const * const *argv)
 	return value_new_float (pnorm (x, 0, 1, TRUE, FALSE));
 }
 
+static gboolean
+gnumeric_normsdist_vector (GnmFunc *func, GnmFuncEvalInfo *ei,
+			   gnm_float *xs, int n, gpointer data)
+{
+	pnorm_vec (xs, n, 0, 1, TRUE, FALSE);
+	return TRUE;
+}
+
 /***************************************************************************/
 
 static GnmFuncHelp const help_snorm_dist_range[] = {
@@ -500,6 +541,19 @@ gnumeric_normsinv (GnmFuncEvalInfo *ei, GnmValue const * const *argv)
 	return value_new_float (qnorm (p, 0, 1, TRUE, FALSE));
 }
 
+static gboolean
+gnumeric_normsinv_vector (GnmFunc *func, GnmFuncEvalInfo *ei,
+			  gnm_float *xs, int n, gpointer data)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		if (xs[i] < 0 || xs[i] > 1)
+			xs[i] = gnm_nan;
+	qnorm_vec (xs, n, 0, 1, TRUE, FALSE);
+	return TRUE;
+}
+
 /***************************************************************************/
 
 static GnmFuncHelp const help_owent[] = {
@@ -2245,13 +2299,30 @@ static GnmFuncHelp const help_median[] = {
 static GnmValue *
 gnumeric_median (GnmFuncEvalInfo *ei, int argc, GnmExprConstPtr const *argv)
 {
-	return float_range_function (argc, argv, ei,
-				     gnm_range_median_inter_sorted,
-				     COLLECT_IGNORE_STRINGS |
-				     COLLECT_IGNORE_BOOLS |
-				     COLLECT_IGNORE_BLANKS |
-				     COLLECT_SORT,
-				     GNM_ERROR_NUM);
+	GnmValue *result = NULL;
+	gnm_float *xs, res;
+	int n;
+	gboolean constp;
+
+	/* Selection rather than sorting.  */
+	xs = collect_floats (argc, argv, ei->pos,
+			     COLLECT_IGNORE_STRINGS |
+			     COLLECT_IGNORE_BOOLS |
+			     COLLECT_IGNORE_BLANKS |
+			     COLLECT_ORDER_IRRELEVANT,
+			     &n, &result, NULL, &constp);
+	if (!xs)
+		return result;
+	if (constp)
+		xs = g_memdup (xs, MAX (1, n) * sizeof (gnm_float));
+
+	if (gnm_range_median_inter_nonsorted (xs, n, &res))
+		result = value_new_error_NUM (ei->pos);
+	else
+		result = value_new_float (res);
+
+	g_free (xs);
+	return result;
 }
 
 /***************************************************************************/
@@ -2379,12 +2450,13 @@ gnumeric_large (GnmFuncEvalInfo *ei, GnmValue const * const *argv)
 {
 	int n;
 	GnmValue *res = NULL;
-	gnm_float *xs = collect_floats_value (argv[0], ei->pos,
-					      COLLECT_IGNORE_STRINGS |
-					      COLLECT_IGNORE_BOOLS |
-					      COLLECT_IGNORE_BLANKS |
-					      COLLECT_SORT,
-					      &n, &res);
+	gboolean constp;
+	gnm_float *xs = collect_floats_value_shared (argv[0], ei->pos,
+						     COLLECT_IGNORE_STRINGS |
+						     COLLECT_IGNORE_BOOLS |
+						     COLLECT_IGNORE_BLANKS |
+						     COLLECT_SORT,
+						     &n, &res, &constp);
 	gnm_float k = value_get_as_float (argv[1]);
 	if (res)
 		return res;
@@ -2395,7 +2467,8 @@ gnumeric_large (GnmFuncEvalInfo *ei, GnmValue const * const *argv)
 	else
 		res = value_new_error_NUM (ei->pos);
 
-	g_free (xs);
+	if (!constp)
+		g_free (xs);
 	return res;
 }
 
@@ -2423,12 +2496,13 @@ gnumeric_small (GnmFuncEvalInfo *ei, GnmValue const * const *argv)
 {
 	int n;
 	GnmValue *res = NULL;
-	gnm_float *xs = collect_floats_value (argv[0], ei->pos,
-					      COLLECT_IGNORE_STRINGS |
-					      COLLECT_IGNORE_BOOLS |
-					      COLLECT_IGNORE_BLANKS |
-					      COLLECT_SORT,
-					      &n, &res);
+	gboolean constp;
+	gnm_float *xs = collect_floats_value_shared (argv[0], ei->pos,
+						     COLLECT_IGNORE_STRINGS |
+						     COLLECT_IGNORE_BOOLS |
+						     COLLECT_IGNORE_BLANKS |
+						     COLLECT_SORT,
+						     &n, &res, &constp);
 	gnm_float k = value_get_as_float (argv[1]);
 	if (res)
 		return res;
@@ -2439,7 +2513,8 @@ gnumeric_small (GnmFuncEvalInfo *ei, GnmValue const * const *argv)
 	else
 		res = value_new_error_NUM (ei->pos);
 
-	g_free (xs);
+	if (!constp)
+		g_free (xs);
 	return res;
 }
 
@@ -2852,16 +2927,17 @@ gnumeric_percentrank (GnmFuncEvalInfo *ei, GnmValue const * const *argv)
 {
 	gnm_float *data, x, significance, r;
 	GnmValue *result = NULL;
-	int i, n;
+	int n, less, not_greater;
 	int n_equal, n_smaller, n_larger;
 	gnm_float x_larger, x_smaller;
+	gboolean constp;
 
-	data = collect_floats_value (argv[0], ei->pos,
-				     COLLECT_IGNORE_STRINGS |
-				     COLLECT_IGNORE_BOOLS |
-				     COLLECT_IGNORE_BLANKS |
-				     COLLECT_ORDER_IRRELEVANT,
-				     &n, &result);
+	data = collect_floats_value_shared (argv[0], ei->pos,
+					    COLLECT_IGNORE_STRINGS |
+					    COLLECT_IGNORE_BOOLS |
+					    COLLECT_IGNORE_BLANKS |
+					    COLLECT_SORT,
+					    &n, &result, &constp);
 	x = value_get_as_float (argv[1]);
 	significance = argv[2] ? value_get_as_float (argv[2]) : 3;
 
@@ -2873,22 +2949,13 @@ gnumeric_percentrank (GnmFuncEvalInfo *ei, GnmValue const * const *argv)
 		goto done;
 	}
 
-	n_equal = n_smaller = n_larger = 0;
-	x_larger = x_smaller = 42;
-	for (i = 0; i < n; i++) {
-		gnm_float y = data[i];
-
-		if (y < x) {
-			if (n_smaller == 0 || x_smaller < y)
-				x_smaller = y;
-			n_smaller++;
-		} else if (y > x) {
-			if (n_larger == 0 || x_larger > y)
-				x_larger = y;
-			n_larger++;
-		} else
-			n_equal++;
-	}
+	less = sorted_count_less (data, n, x);
+	not_greater = sorted_count_not_greater (data, n, x);
+	n_smaller = less;
+	n_equal = not_greater - less;
+	n_larger = n - not_greater;
+	x_smaller = n_smaller > 0 ? data[less - 1] : 42;
+	x_larger = n_larger > 0 ? data[not_greater] : 42;
 
 	if (n_smaller + n_equal == 0 || n_larger + n_equal == 0) {
 		result = value_new_error_NA (ei->pos);
@@ -2926,7 +2993,8 @@ gnumeric_percentrank (GnmFuncEvalInfo *ei, GnmValue const * const *argv)
 	result = value_new_float (r);
 
  done:
-	g_free (data);
+	if (!constp)
+		g_free (data);
 	return result;
 }
 
@@ -2956,16 +3024,17 @@ gnumeric_percentrank_exc (GnmFuncEvalInfo *ei, GnmValue const * const *argv)
 {
 	gnm_float *data, x, significance, r;
 	GnmValue *result = NULL;
-	int i, n;
+	int n, less, not_greater;
 	int n_equal, n_smaller, n_larger;
 	gnm_float x_larger, x_smaller;
+	gboolean constp;
 
-	data = collect_floats_value (argv[0], ei->pos,
-				     COLLECT_IGNORE_STRINGS |
-				     COLLECT_IGNORE_BOOLS |
-				     COLLECT_IGNORE_BLANKS |
-				     COLLECT_ORDER_IRRELEVANT,
-				     &n, &result);
+	data = collect_floats_value_shared (argv[0], ei->pos,
+					    COLLECT_IGNORE_STRINGS |
+					    COLLECT_IGNORE_BOOLS |
+					    COLLECT_IGNORE_BLANKS |
+					    COLLECT_SORT,
+					    &n, &result, &constp);
 	x = value_get_as_float (argv[1]);
 	significance = argv[2] ? value_get_as_float (argv[2]) : 3;
 
@@ -2977,22 +3046,13 @@ gnumeric_percentrank_exc (GnmFuncEvalInfo *ei, GnmValue const * const *argv)
 		goto done;
 	}
 
-	n_equal = n_smaller = n_larger = 0;
-	x_larger = x_smaller = 42;
-	for (i = 0; i < n; i++) {
-		gnm_float y = data[i];
-
-		if (y < x) {
-			if (n_smaller == 0 || x_smaller < y)
-				x_smaller = y;
-			n_smaller++;
-		} else if (y > x) {
-			if (n_larger == 0 || x_larger > y)
-				x_larger = y;
-			n_larger++;
-		} else
-			n_equal++;
-	}
+	less = sorted_count_less (data, n, x);
+	not_greater = sorted_count_not_greater (data, n, x);
+	n_smaller = less;
+	n_equal = not_greater - less;
+	n_larger = n - not_greater;
+	x_smaller = n_smaller > 0 ? data[less - 1] : 42;
+	x_larger = n_larger > 0 ? data[not_greater] : 42;
 
 	if (n_smaller + n_equal == 0 || n_larger + n_equal == 0) {
 		result = value_new_error_NA (ei->pos);
@@ -3029,7 +3089,8 @@ gnumeric_percentrank_exc (GnmFuncEvalInfo *ei, GnmValue const * const *argv)
 	result = value_new_float (r);
 
  done:
-	g_free (data);
+	if (!constp)
+		g_free (data);
 	return result;
 }
 
@@ -3059,13 +3120,13 @@ gnumeric_percentile (GnmFuncEvalInfo *ei, GnmValue const * const *argv)
 				     COLLECT_IGNORE_STRINGS |
 				     COLLECT_IGNORE_BOOLS |
 				     COLLECT_IGNORE_BLANKS |
-				     COLLECT_SORT,
+				     COLLECT_ORDER_IRRELEVANT,
 				     &n, &result);
 	if (!result) {
 		gnm_float p = value_get_as_float (argv[1]);
 		gnm_float res;
 
-		if (gnm_range_fractile_inter_sorted (data, n, &res, p))
+		if (gnm_range_fractile_inter_nonsorted (data, n, &res, p))
 			result = value_new_error_NUM (ei->pos);
 		else
 			result = value_new_float (res);
@@ -3101,7 +3162,7 @@ gnumeric_percentile_exc (GnmFuncEvalInfo *ei, GnmValue const * const *argv)
 				     COLLECT_IGNORE_STRINGS |
 				     COLLECT_IGNORE_BOOLS |
 				     COLLECT_IGNORE_BLANKS |
-				     COLLECT_SORT,
+				     COLLECT_ORDER_IRRELEVANT,
 				     &n, &result);
 	if (!result) {
 		if (n > 1) {
@@ -3109,7 +3170,7 @@ gnumeric_percentile_exc (GnmFuncEvalInfo *ei, GnmValue const * const *argv)
 			gnm_float res;
 			gnm_float fr = (p * (n + 1) - 1)/(n-1);
 
-			if (gnm_range_fractile_inter_sorted (data, n, &res, fr))
+			if (gnm_range_fractile_inter_nonsorted (data, n, &res, fr))
 				result = value_new_error_NUM (ei->pos);
 			else
 				result = value_new_float (res);
@@ -3147,13 +3208,13 @@ gnumeric_quartile (GnmFuncEvalInfo *ei, GnmValue const * const *argv)
 				     COLLECT_IGNORE_STRINGS |
 				     COLLECT_IGNORE_BOOLS |
 				     COLLECT_IGNORE_BLANKS |
-				     COLLECT_SORT,
+				     COLLECT_ORDER_IRRELEVANT,
 				     &n, &result);
 	if (!result) {
 		gnm_float q = gnm_fake_floor (value_get_as_float (argv[1]));
 		gnm_float res;
 
-		if (gnm_range_fractile_inter_sorted (data, n, &res, q / 4.0))
+		if (gnm_range_fractile_inter_nonsorted (data, n, &res, q / 4.0))
 			result = value_new_error_NUM (ei->pos);
 		else
 			result = value_new_float (res);
@@ -3190,7 +3251,7 @@ gnumeric_quartile_exc (GnmFuncEvalInfo *ei, GnmValue const * const *argv)
 				     COLLECT_IGNORE_STRINGS |
 				     COLLECT_IGNORE_BOOLS |
 				     COLLECT_IGNORE_BLANKS |
-				     COLLECT_SORT,
+				     COLLECT_ORDER_IRRELEVANT,
 				     &n, &result);
 	if (!result) {
 		if (n > 1) {
@@ -3198,7 +3259,7 @@ gnumeric_quartile_exc (GnmFuncEvalInfo *ei, GnmValue const * const *argv)
 			gnm_float res;
 			gnm_float fr = ((q / 4.0) * (n + 1) - 1)/(n-1);
 
-			if (gnm_range_fractile_inter_sorted (data, n, &res, fr))
+			if (gnm_range_fractile_inter_nonsorted (data, n, &res, fr))
 				result = value_new_error_NUM (ei->pos);
 			else
 				result = value_new_float (res);
@@ -5355,16 +5416,16 @@ GnmFuncDescriptor const stat_functions[] = {
 
 	{ "betadist",     "fff|ff",
 	  help_betadist, gnumeric_betadist, NULL,
-	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
+	  GNM_FUNC_PURE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
 	{ "beta.dist",     "fffb|ff",
 	  help_beta_dist, gnumeric_beta_dist, NULL,
-	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
+	  GNM_FUNC_PURE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
 	{ "betainv",      "fff|ff",
 	  help_betainv, gnumeric_betainv, NULL,
-	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
+	  GNM_FUNC_PURE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
 	{ "binomdist",    "fffb",
 	  help_binomdist, gnumeric_binomdist, NULL,
-	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
+	  GNM_FUNC_PURE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
 	{ "binom.dist.range",    "fff|f",
 	  help_binom_dist_range, gnumeric_binom_dist_range, NULL,
 	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_UNIQUE_TO_GNUMERIC, GNM_FUNC_TEST_STATUS_NO_TESTSUITE },
@@ -5375,10 +5436,10 @@ GnmFuncDescriptor const stat_functions[] = {
 
 	{ "chidist",      "ff",
 	  help_chidist, gnumeric_chidist, NULL,
-	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
+	  GNM_FUNC_PURE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
 	{ "chiinv",       "ff",
 	  help_chiinv, gnumeric_chiinv, NULL,
-	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
+	  GNM_FUNC_PURE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
 	{ "chitest",      "AA",
 	  help_chitest, gnumeric_chitest, NULL,
 	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
@@ -5407,19 +5468,19 @@ GnmFuncDescriptor const stat_functions[] = {
 	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
 	{ "critbinom",    "fff",
 	  help_critbinom, gnumeric_critbinom, NULL,
-	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
+	  GNM_FUNC_PURE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
 	{ "devsq", NULL,
 	  help_devsq, NULL, gnumeric_devsq,
 	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
 	{ "expondist",    "ffb",
 	  help_expondist, gnumeric_expondist, NULL,
-	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
+	  GNM_FUNC_PURE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
 	{ "fdist",        "fff",
 	  help_fdist, gnumeric_fdist, NULL,
-	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
+	  GNM_FUNC_PURE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
 	{ "finv",         "fff",
 	  help_finv, gnumeric_finv, NULL,
-	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
+	  GNM_FUNC_PURE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
 	{ "fisher",       "f",
 	  help_fisher, gnumeric_fisher, NULL,
 	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
@@ -5437,10 +5498,10 @@ GnmFuncDescriptor const stat_functions[] = {
 	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
 	{ "gammadist",    "fffb",
 	  help_gammadist, gnumeric_gammadist, NULL,
-	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
+	  GNM_FUNC_PURE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
 	{ "gammainv",     "fff",
 	  help_gammainv, gnumeric_gammainv, NULL,
-	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
+	  GNM_FUNC_PURE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
 	{ "geomean", NULL,
 	  help_geomean, NULL, gnumeric_geomean,
 	  GNM_FUNC_SIMPLE + GNM_FUNC_AUTO_FIRST,
@@ -5454,7 +5515,7 @@ GnmFuncDescriptor const stat_functions[] = {
 	  GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
 	{ "hypgeomdist",  "ffff|b",
 	  help_hypgeomdist, gnumeric_hypgeomdist, NULL,
-	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
+	  GNM_FUNC_PURE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
 	{ "intercept",    "AA",
 	  help_intercept, gnumeric_intercept, NULL,
 	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
@@ -5479,10 +5540,10 @@ GnmFuncDescriptor const stat_functions[] = {
 	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_UNIQUE_TO_GNUMERIC, GNM_FUNC_TEST_STATUS_NO_TESTSUITE },
 	{ "loginv",       "fff",
 	  help_loginv, gnumeric_loginv, NULL,
-	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
+	  GNM_FUNC_PURE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
 	{ "lognormdist",  "fff",
 	  help_lognormdist, gnumeric_lognormdist, NULL,
-	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
+	  GNM_FUNC_PURE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
 	{ "logreg",       "A|Abb",
 	  help_logreg, gnumeric_logreg, NULL,
 	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_UNIQUE_TO_GNUMERIC, GNM_FUNC_TEST_STATUS_NO_TESTSUITE },
@@ -5516,23 +5577,23 @@ GnmFuncDescriptor const stat_functions[] = {
 	  GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_NO_TESTSUITE},
 	{ "negbinomdist", "fff",
 	  help_negbinomdist, gnumeric_negbinomdist, NULL,
-	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
+	  GNM_FUNC_PURE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
 	{ "normdist",     "fffb",
 	  help_normdist, gnumeric_normdist, NULL,
-	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
+	  GNM_FUNC_PURE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
 	{ "snorm.dist.range", "ff",
 	  help_snorm_dist_range, gnumeric_snorm_dist_range, NULL,
 	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_UNIQUE_TO_GNUMERIC, GNM_FUNC_TEST_STATUS_NO_TESTSUITE,
 	},
 	{ "norminv",      "fff",
 	  help_norminv, gnumeric_norminv, NULL,
-	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
+	  GNM_FUNC_PURE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
 	{ "normsdist",    "f",
 	  help_normsdist, gnumeric_normsdist, NULL,
-	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
+	  GNM_FUNC_PURE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
 	{ "normsinv",     "f",
 	  help_normsinv, gnumeric_normsinv, NULL,
-	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
+	  GNM_FUNC_PURE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
 	{ "owent",    "ff",
 	  help_owent, gnumeric_owent, NULL,
 	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_UNIQUE_TO_GNUMERIC, GNM_FUNC_TEST_STATUS_EXHAUSTIVE },
@@ -5557,7 +5618,7 @@ GnmFuncDescriptor const stat_functions[] = {
 	  GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
 	{ "poisson",      "ffb",
 	  help_poisson, gnumeric_poisson, NULL,
-	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
+	  GNM_FUNC_PURE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
 	{ "prob",         "AAf|f",
 	  help_prob, gnumeric_prob, NULL,
 	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
@@ -5613,10 +5674,10 @@ GnmFuncDescriptor const stat_functions[] = {
 	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
 	{ "tdist",        "fff",
 	  help_tdist, gnumeric_tdist, NULL,
-	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
+	  GNM_FUNC_PURE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
 	{ "tinv",         "ff",
 	  help_tinv, gnumeric_tinv, NULL,
-	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
+	  GNM_FUNC_PURE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
 	{ "trend",        "A|AAb",
 	  help_trend, gnumeric_trend, NULL,
 	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
@@ -5641,7 +5702,7 @@ GnmFuncDescriptor const stat_functions[] = {
 	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
 	{ "weibull",      "fffb",
 	  help_weibull, gnumeric_weibull, NULL,
-	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
+	  GNM_FUNC_PURE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
 	{ "ztest", "Af|f",
 	  help_ztest, gnumeric_ztest, NULL,
 	  GNM_FUNC_SIMPLE, GNM_FUNC_IMPL_STATUS_COMPLETE, GNM_FUNC_TEST_STATUS_BASIC },
@@ -5689,3 +5750,17 @@ GnmFuncDescriptor const stat_functions[] = {
 
 	{NULL}
 };
+
+G_MODULE_EXPORT void
+go_plugin_init (GOPlugin *plugin, GOCmdContext *cc)
+{
+	g_signal_connect (gnm_func_lookup ("normsdist", NULL),
+			  "eval-vector", G_CALLBACK (gnumeric_normsdist_vector), NULL);
+	g_signal_connect (gnm_func_lookup ("normsinv", NULL),
+			  "eval-vector", G_CALLBACK (gnumeric_normsinv_vector), NULL);
+}
+
+G_MODULE_EXPORT void
+go_plugin_shutdown (GOPlugin *plugin, GOCmdContext *cc)
+{
+}
@@ -608,7 +608,7 @@ write_row (GsfOutput *output, Sheet *sheet, gint row, GnmRange *range, html_vers
 {
 	gint col;
 	ColRowInfo const *ri = sheet_row_get_info (sheet, row);
-	if (ri->needs_respan)
+	if (row_needs_respan (ri, sheet))
 		row_calc_spans ((ColRowInfo *) ri, row, sheet);
 
 	for (col = range->start.col; col <= range->end.col; col++) {
@@ -1363,7 +1363,7 @@ latex_file_save (GOFileSaver const *fs, G_GNUC_UNUSED GOIOContext *io_context,
 	for (row = total_range.start.row; row <= total_range.end.row; row++) {
 		ColRowInfo const * ri;
 		ri = sheet_row_get_info (current_sheet, row);
-		if (ri->needs_respan)
+		if (row_needs_respan (ri, current_sheet))
 			row_calc_spans ((ColRowInfo *) ri, row, current_sheet);
 
 		/* We need to check for horizontal borders at the top of this row */
@@ -1581,7 +1581,7 @@ latex_table_file_save_impl (GOFileSaver const *fs, WorkbookView const *wb_view,
 		ColRowInfo const * ri;
 		ri = sheet_row_get_info (current_sheet, row);
 		if (all || ri->visible) {
-			if (ri->needs_respan)
+			if (row_needs_respan (ri, current_sheet))
 				row_calc_spans ((ColRowInfo *) ri, row, current_sheet);
 
 			for (col = total_range.start.col; col <= total_range.end.col; col++) {
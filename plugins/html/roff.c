@@ -106,7 +106,7 @@ roff_file_save (GOFileSaver const *fs, GOIOContext *io_context,
 		for (row = r.start.row; row <= r.end.row; row++) {
 			ColRowInfo const * ri;
 			ri = sheet_row_get_info (sheet, row);
-			if (ri->needs_respan)
+			if (row_needs_respan (ri, sheet))
 				row_calc_spans ((ColRowInfo *) ri, row, sheet);
 
 			if (row > r.start.row)
@@ -1487,7 +1487,7 @@ oo_cellref_parse (GnmCellRef *ref, char const *start, GnmParsePos const *pp,
 {
 	char const *tmp, *ptr = start;
 	GnmSheetSize const *ss;
-	GnmSheetSize ss_max = { GNM_MAX_COLS, GNM_MAX_ROWS};
+	GnmSheetSize ss_max = { GNM_MAX_COLS, gnm_sheet_max_rows_limit ()};
 	Sheet *sheet;
 
 	if (*ptr != '.') {
@@ -11883,7 +11883,7 @@ odf_sheet_suggest_size (GsfXMLIn *xin, int *cols, int *rows)
 	while (c < *cols && c < GNM_MAX_COLS)
 		c *= 2;
 
-	while (r < *rows && r < GNM_MAX_ROWS)
+	while (r < *rows && r < gnm_sheet_max_rows_limit ())
 		r *= 2;
 
 	while (!gnm_sheet_valid_size (c, r))
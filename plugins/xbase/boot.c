@@ -152,7 +152,7 @@ xbase_file_open (GOFileOpener const *fo, GOIOContext *io_context,
 	XBrecord  *record;
 	Sheet	  *sheet = NULL;
 	GOErrorInfo *open_error;
-	int rows = GNM_MAX_ROWS;
+	int rows = gnm_sheet_max_rows_limit ();
 	int pass;
 
 	if ((file = xbase_open (input, &open_error)) == NULL) {
@@ -21,6 +21,7 @@
 
 #include <cell.h>
 #include <sheet.h>
+#include <sheet-private.h>
 #include <sheet-merge.h>
 #include <sheet-style.h>
 #include <style.h>
@@ -453,4 +454,24 @@ row_calc_spans (ColRowInfo *ri, int row, Sheet const *sheet)
 	}
 
 	ri->needs_respan = FALSE;
+	ri->span_generation = sheet->priv->span_generation;
+}
+
+/**
+ * row_needs_respan:
+ * @ri: #ColRowInfo for the row
+ * @sheet: #Sheet
+ *
+ * Returns: %TRUE if the spans of @ri must be recalculated with
+ * row_calc_spans before use.  That is the case when the row was
+ * queued explicitly or when it was last spanned before the most recent
+ * sheet-wide invalidation.  The default row never needs spans.
+ */
+gboolean
+row_needs_respan (ColRowInfo const *ri, Sheet const *sheet)
+{
+	if (ri->is_default)
+		return FALSE;
+	return ri->needs_respan ||
+		ri->span_generation != sheet->priv->span_generation;
 }
@@ -20,6 +20,7 @@ GType               cell_span_info_get_type (void);
 CellSpanInfo const *row_span_get     (ColRowInfo const *ri, int col);
 void		    row_destroy_span (ColRowInfo *ri);
 void		    row_calc_spans   (ColRowInfo *ri, int row, Sheet const *sheet);
+gboolean	    row_needs_respan (ColRowInfo const *ri, Sheet const *sheet);
 
 G_END_DECLS
 
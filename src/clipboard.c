@@ -272,8 +272,12 @@ paste_cell (int target_col, int target_row,
 	else {
 		GnmCell *dst = sheet_cell_fetch (dst_sheet, target_col, target_row);
 		if (NULL != src->texpr && (paste_flags & PASTE_CONTENTS)) {
-			GnmExprTop const *relo = gnm_expr_top_relocate (
-				src->texpr, &dat->rinfo, FALSE);
+			/* Most pasted formulas come out unchanged; those then
+			 * share the copied expression.  */
+			GnmExprTop const *relo =
+				gnm_expr_top_relocate_is_shift (src->texpr, &dat->rinfo)
+				? NULL
+				: gnm_expr_top_relocate (src->texpr, &dat->rinfo, FALSE);
 			if (paste_flags & PASTE_TRANSPOSE) {
 				GnmExprTop const *trelo =
 					gnm_expr_top_transpose (relo ? relo : src->texpr);
@@ -775,25 +779,70 @@ cb_clipboard_copy_range_undo (GnmCellRegion *cr, GnmSheetRange *sr,
 		 cc);
 }
 
+static void
+cb_cellregion_share_expr (G_GNUC_UNUSED gpointer key, GnmCellCopy *cc,
+			  GnmExprSharer *es)
+{
+	if (cc->texpr)
+		cc->texpr = gnm_expr_sharer_share (es, cc->texpr);
+}
+
+/*
+ * Undo regions can live for a long time, so make copies of the same
+ * formula (typically a filled block) share one expression.
+ */
+static void
+cellregion_compact (GnmCellRegion *cr)
+{
+	GnmExprSharer *es;
+
+	if (cr->cell_content == NULL)
+		return;
+
+	es = gnm_expr_sharer_new ();
+	g_hash_table_foreach (cr->cell_content,
+			      (GHFunc)cb_cellregion_share_expr, es);
+	gnm_expr_sharer_destroy (es);
+}
+
 /**
- * clipboard_copy_range_undo:
+ * clipboard_copy_range_undo_size:
  * @sheet: #Sheet
  * @r: #GnmRange
+ * @psize: (out) (optional): the size, in undo units, of what was saved
  *
  * Returns: (transfer full): A #GOUndo object that will restore the contents
  * of the given range.
  **/
 GOUndo *
-clipboard_copy_range_undo (Sheet *sheet, GnmRange const *r)
+clipboard_copy_range_undo_size (Sheet *sheet, GnmRange const *r,
+				gint64 *psize)
 {
 	GnmCellRegion *cr = clipboard_copy_range (sheet, r);
 	g_return_val_if_fail (cr != NULL, NULL);
+	cellregion_compact (cr);
+	if (psize)
+		*psize = cellregion_cmd_size (cr);
 	return go_undo_binary_new (cr, gnm_sheet_range_new (sheet, r),
 				   (GOUndoBinaryFunc)cb_clipboard_copy_range_undo,
 				   (GFreeFunc)cellregion_unref,
 				   (GFreeFunc)g_free);
 }
 
+/**
+ * clipboard_copy_range_undo:
+ * @sheet: #Sheet
+ * @r: #GnmRange
+ *
+ * Returns: (transfer full): A #GOUndo object that will restore the contents
+ * of the given range.
+ **/
+GOUndo *
+clipboard_copy_range_undo (Sheet *sheet, GnmRange const *r)
+{
+	return clipboard_copy_range_undo_size (sheet, r, NULL);
+}
+
 /**
  * clipboard_copy_ranges_undo:
  * @sheet: #Sheet
@@ -1190,17 +1239,72 @@ cellregion_to_string (GnmCellRegion const *cr,
 	return all;
 }
 
+/* Bytes of cell text or formula structure that count as one undo unit.  */
+#define CELLREGION_UNIT_BYTES 64
+
+typedef struct {
+	GHashTable *texprs;
+	gint64 bytes;
+} CellRegionSize;
+
+static GnmExpr const *
+cb_count_expr_nodes (G_GNUC_UNUSED GnmExpr const *expr, GnmExprWalk *data)
+{
+	(*(gint64 *)data->user)++;
+	return NULL;
+}
+
+static void
+cb_cellregion_size (G_GNUC_UNUSED gpointer key, GnmCellCopy const *cc,
+		    CellRegionSize *crs)
+{
+	GnmValue const *v = cc->val;
+
+	if (v && VALUE_IS_STRING (v))
+		crs->bytes += strlen (value_peek_string (v));
+
+	/* Shared expressions are paid for once.  */
+	if (cc->texpr &&
+	    !g_hash_table_contains (crs->texprs, cc->texpr)) {
+		gint64 nodes = 0;
+		g_hash_table_add (crs->texprs, (gpointer)cc->texpr);
+		gnm_expr_walk (cc->texpr->expr, cb_count_expr_nodes, &nodes);
+		crs->bytes += nodes * (CELLREGION_UNIT_BYTES / 2);
+	}
+}
+
+/**
+ * cellregion_cmd_size:
+ * @cr: #GnmCellRegion
+ *
+ * Returns: the undo size of @cr.  Each cell, style region, merge and
+ * object is one unit; long strings and distinct formulas add a unit per
+ * CELLREGION_UNIT_BYTES of content.  No sizeof is involved so the result
+ * is the same on all platforms.
+ **/
 int
 cellregion_cmd_size (GnmCellRegion const *cr)
 {
-	int res = 1;
+	gint64 res = 1;
 
 	g_return_val_if_fail (cr != NULL, 1);
 
 	res += g_slist_length (cr->styles);
-	if (NULL != cr->cell_content)
+	res += g_slist_length (cr->merged);
+	res += g_slist_length (cr->objects);
+	if (NULL != cr->cell_content) {
+		CellRegionSize crs;
+
+		crs.texprs = g_hash_table_new (g_direct_hash, g_direct_equal);
+		crs.bytes = 0;
+		g_hash_table_foreach (cr->cell_content,
+				      (GHFunc)cb_cellregion_size, &crs);
+		g_hash_table_destroy (crs.texprs);
+
 		res += g_hash_table_size (cr->cell_content);
-	return res;
+		res += crs.bytes / CELLREGION_UNIT_BYTES;
+	}
+	return (int)MIN (res, G_MAXINT / 2);
 }
 
 static void
@@ -95,6 +95,8 @@ GnmPasteTarget *gnm_paste_target_new (Sheet *sheet, GnmRange *r, GnmPasteFlags f
 
 GnmCellRegion  *clipboard_copy_range   (Sheet *sheet, GnmRange const *r);
 GOUndo         *clipboard_copy_range_undo (Sheet *sheet, GnmRange const *r);
+GOUndo         *clipboard_copy_range_undo_size (Sheet *sheet, GnmRange const *r,
+						gint64 *psize);
 GOUndo         *clipboard_copy_ranges_undo (Sheet *sheet, GSList *ranges);
 GnmCellRegion  *clipboard_copy_obj     (Sheet *sheet, GSList *objects);
 gboolean        clipboard_paste_region (GnmCellRegion const *cr,
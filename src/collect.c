@@ -20,6 +20,7 @@
 #include <sheet.h>
 #include <ranges.h>
 #include <number-match.h>
+#include <sort.h>
 #include <goffice/goffice.h>
 #include <stdlib.h>
 #include <string.h>
@@ -289,20 +290,6 @@ get_single_cache_key (GnmExpr const *e, GnmEvalPos const *ep)
 
 /* ------------------------------------------------------------------------- */
 
-static int
-float_compare (const void *a_, const void *b_)
-{
-	gnm_float const *a = a_;
-	gnm_float const *b = b_;
-
-        if (*a < *b)
-                return -1;
-	else if (*a == *b)
-		return 0;
-	else
-		return 1;
-}
-
 typedef struct {
 	guint alloc_count;
 	gnm_float *data;
@@ -509,8 +496,7 @@ collect_floats (int argc, GnmExprConstPtr const *argv,
 		}
 
 		if (flags & COLLECT_SORT) {
-			qsort (cl.data, cl.count, sizeof (cl.data[0]),
-			       float_compare);
+			gnm_sort_floats (cl.data, cl.count);
 		}
 	}
 
@@ -565,6 +551,27 @@ collect_floats_value (GnmValue const *val, GnmEvalPos const *ep,
 	return collect_floats (1, argv, ep, flags, n, error, NULL, NULL);
 }
 
+/**
+ * collect_floats_value_shared: (skip)
+ * @constp: (out): set if the result belongs to the cache.
+ *
+ * Like collect_floats_value, but hands out the cached data instead of a
+ * copy when possible.  If *constp is set, the result must be neither
+ * changed nor freed.  This makes repeated lookups in a big sorted range,
+ * as done by RANK, cheap.
+ */
+gnm_float *
+collect_floats_value_shared (GnmValue const *val, GnmEvalPos const *ep,
+			     CollectFlags flags, int *n, GnmValue **error,
+			     gboolean *constp)
+{
+	GnmExpr expr_val;
+	GnmExprConstPtr argv[1] = { &expr_val };
+
+	gnm_expr_constant_init (&expr_val.constant, val);
+	return collect_floats (1, argv, ep, flags, n, error, NULL, constp);
+}
+
 /* ------------------------------------------------------------------------- */
 /**
  * collect_floats_value_with_info:
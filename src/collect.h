@@ -38,6 +38,11 @@ gnm_float *collect_floats_value (GnmValue const *val,
 				 GnmEvalPos const *ep,
 				 CollectFlags flags,
 				 int *n, GnmValue **error);
+gnm_float *collect_floats_value_shared (GnmValue const *val,
+					GnmEvalPos const *ep,
+					CollectFlags flags,
+					int *n, GnmValue **error,
+					gboolean *constp);
 gnm_float *collect_floats (int argc, GnmExprConstPtr const *argv,
 			   GnmEvalPos const *ep, CollectFlags flags,
 			   int *n, GnmValue **error, GSList **info,
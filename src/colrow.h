@@ -5,6 +5,10 @@
 
 G_BEGIN_DECLS
 
+/* Width of the per-row span generation stamp.  */
+#define COLROW_SPAN_GENERATION_BITS 20
+#define COLROW_SPAN_GENERATION_MASK ((1u << COLROW_SPAN_GENERATION_BITS) - 1)
+
 struct _ColRowInfo {
 	/* Size including margins, and right grid line */
 	double	 size_pts;
@@ -18,6 +22,7 @@ struct _ColRowInfo {
 	unsigned  in_filter     : 1;	/* in a filter */
 	unsigned  in_advanced_filter : 1; /* in an advanced filter */
 	unsigned  needs_respan  : 1;	/* mark a row as needing span generation */
+	unsigned  span_generation : COLROW_SPAN_GENERATION_BITS; /* see row_needs_respan */
 
 	/* TODO : Add per row/col min/max */
 
@@ -577,7 +577,8 @@ command_list_release (GSList *cmd_list)
 #undef DEBUG_TRUNCATE_UNDO
 
 /*
- * Truncate the undo list if it is too big.
+ * Truncate the undo list if it is too big.  The undo size preference is
+ * a hard budget: everything but the most recent item must fit in it.
  *
  * Returns -1 if no truncation was done, or else the number of elements
  * left.
@@ -600,7 +601,6 @@ truncate_undo_info (Workbook *wb)
 	for (l = wb->undo_commands, prev = NULL, ok_count = 0;
 	     l;
 	     prev = l, l = l->next, ok_count++) {
-		int min_leave;
 		GnmCommand *cmd = GNM_COMMAND (l->data);
 		int size = cmd->size;
 
@@ -631,12 +631,7 @@ truncate_undo_info (Workbook *wb)
 			return ok_count;
 		}
 
-		/*
-		 * In order to allow a series of useful small items behind
-		 * a big item, leave at least 10% of current item's size.
-		 */
-		min_leave = size / 10;
-		size_left = MAX (size_left - size, min_leave);
+		size_left -= size;
 	}
 
 #ifdef DEBUG_TRUNCATE_UNDO
@@ -1275,9 +1270,6 @@ typedef struct {
 	GnmRange        *cutcopied;
 	SheetView	*cut_copy_view;
 
-	gboolean       (*redo_action) (Sheet *sheet, int col, int count,
-				       GOUndo **pundo, GOCmdContext *cc);
-
 	gboolean       (*repeat_action) (WorkbookControl *wbc, Sheet *sheet,
 					 int start, int count);
 
@@ -1335,12 +1327,22 @@ cmd_ins_del_colrow_redo (GnmCommand *cmd, WorkbookControl *wbc)
 	GOCmdContext *cc = GO_CMD_CONTEXT (wbc);
 	int idx = me->index;
 	int count = me->count;
+	gint64 undo_size;
 
-	if (me->redo_action (me->sheet, idx, count, &me->undo, cc)) {
+	if (sheet_colrow_insdel (me->sheet, me->is_cols, me->is_insert,
+				 idx, count, &me->undo, &undo_size, cc)) {
 		/* Trouble.  */
 		return TRUE;
 	}
 
+	/* Charge for the contents that the undo had to save.  */
+	if (me->cmd.size == 1) {
+		gint64 size = count + undo_size;
+		me->cmd.size = (int)MIN (size, G_MAXINT / 2);
+		if (me->cmd.size < 1)
+			me->cmd.size = 1;
+	}
+
 	/* Ins/Del Row/Col re-ants things completely to account
 	 * for the shift of col/rows. */
 	if (me->cutcopied != NULL && me->cut_copy_view != NULL) {
@@ -1408,9 +1410,6 @@ cmd_ins_del_colrow (WorkbookControl *wbc,
 	me->is_insert = is_insert;
 	me->index = index;
 	me->count = count;
-	me->redo_action = me->is_insert
-		? (me->is_cols ? sheet_insert_cols : sheet_insert_rows)
-		: (me->is_cols ? sheet_delete_cols : sheet_delete_rows);
 	me->repeat_action = me->is_insert
 		? (me->is_cols ? cmd_insert_cols : cmd_insert_rows)
 		: (me->is_cols ? cmd_delete_cols : cmd_delete_rows);
@@ -1422,7 +1421,7 @@ cmd_ins_del_colrow (WorkbookControl *wbc,
 	last = first + count - 1;
 	(is_cols ? range_init_cols : range_init_rows) (&r, sheet, first, last);
 
-	/* Note: redo_action checks for array subdivision.  */
+	/* Note: sheet_colrow_insdel checks for array subdivision.  */
 
 	/* Check for locks */
 	if (cmd_cell_range_is_locked_effective (sheet, &r, wbc, descriptor)) {
@@ -1442,7 +1441,7 @@ cmd_ins_del_colrow (WorkbookControl *wbc,
 		me->cutcopied = NULL;
 
 	me->cmd.sheet = sheet;
-	me->cmd.size = count * 10;  /* FIXME?  */
+	me->cmd.size = 1;  /* Changed in initial redo.  */
 	me->cmd.cmd_descriptor = descriptor;
 
 	return gnm_command_push_undo (wbc, G_OBJECT (me));
@@ -1,4 +1,7 @@
 #include <criteria.h>
+#include <application.h>
+#include <ranges.h>
+#include <string.h>
 
 typedef enum { CRIT_NULL, CRIT_FLOAT, CRIT_WRONGTYPE, CRIT_STRING } CritType;
 
@@ -61,6 +64,19 @@ criteria_inspect_values (GnmValue const *x, gnm_float *xr, gnm_float *yr,
 	}
 }
 
+/*
+ * Compare two strings ignoring case.  The collation keys are cached on the
+ * shared GOStrings, so repeated comparisons against the same criterion or
+ * the same cell text do not fold or collate again.
+ */
+static int
+criteria_string_collate (GnmValue const *x, GnmValue const *y)
+{
+	if (x->v_str.val == y->v_str.val)
+		return 0;
+	return strcmp (go_string_get_casefolded_collate (x->v_str.val),
+		       go_string_get_casefolded_collate (y->v_str.val));
+}
 
 static gboolean
 criteria_test_equal (GnmValue const *x, GnmCriteria *crit)
@@ -78,8 +94,9 @@ criteria_test_equal (GnmValue const *x, GnmCriteria *crit)
 		return xf == yf;
 	case CRIT_STRING:
 		/* FIXME: _ascii_??? */
-		return g_ascii_strcasecmp (value_peek_string (x),
-					   value_peek_string (y)) == 0;
+		return x->v_str.val == y->v_str.val ||
+			g_ascii_strcasecmp (value_peek_string (x),
+					    value_peek_string (y)) == 0;
 	}
 }
 
@@ -98,8 +115,9 @@ criteria_test_unequal (GnmValue const *x, GnmCriteria *crit)
 		return xf != yf;
 	case CRIT_STRING:
 		/* FIXME: _ascii_??? */
-		return g_ascii_strcasecmp (value_peek_string (x),
-					   value_peek_string (crit->x)) != 0;
+		return x->v_str.val != crit->x->v_str.val &&
+			g_ascii_strcasecmp (value_peek_string (x),
+					    value_peek_string (crit->x)) != 0;
 	}
 }
 
@@ -116,8 +134,7 @@ criteria_test_less (GnmValue const *x, GnmCriteria *crit)
 	case CRIT_WRONGTYPE:
 		return FALSE;
 	case CRIT_STRING:
-		return go_utf8_collate_casefold (value_peek_string (x),
-						 value_peek_string (y)) < 0;
+		return criteria_string_collate (x, y) < 0;
 	case CRIT_FLOAT:
 		return xf < yf;
 	}
@@ -136,8 +153,7 @@ criteria_test_greater (GnmValue const *x, GnmCriteria *crit)
 	case CRIT_WRONGTYPE:
 		return FALSE;
 	case CRIT_STRING:
-		return go_utf8_collate_casefold (value_peek_string (x),
-						 value_peek_string (y)) > 0;
+		return criteria_string_collate (x, y) > 0;
 	case CRIT_FLOAT:
 		return xf > yf;
 	}
@@ -156,8 +172,7 @@ criteria_test_less_or_equal (GnmValue const *x, GnmCriteria *crit)
 	case CRIT_WRONGTYPE:
 		return FALSE;
 	case CRIT_STRING:
-		return go_utf8_collate_casefold (value_peek_string (x),
-						 value_peek_string (y)) <= 0;
+		return criteria_string_collate (x, y) <= 0;
 	case CRIT_FLOAT:
 		return xf <= yf;
 	}
@@ -176,8 +191,7 @@ criteria_test_greater_or_equal (GnmValue const *x, GnmCriteria *crit)
 	case CRIT_WRONGTYPE:
 		return FALSE;
 	case CRIT_STRING:
-		return go_utf8_collate_casefold (value_peek_string (x),
-						 value_peek_string (y)) >= 0;
+		return criteria_string_collate (x, y) >= 0;
 	case CRIT_FLOAT:
 		return xf >= yf;
 	}
@@ -513,6 +527,38 @@ parse_database_criteria (GnmEvalPos const *ep, GnmValue const *database, GnmValu
 	return res;
 }
 
+static gboolean
+db_row_matches (Sheet *sheet, int row, GSList const *conditions)
+{
+	GnmValue const *empty = value_new_empty ();
+
+	for (; conditions != NULL; conditions = conditions->next) {
+		GnmCriteria *cond = conditions->data;
+		GnmCell *test_cell = sheet_cell_get (sheet, cond->column, row);
+		if (test_cell != NULL)
+			gnm_cell_eval (test_cell);
+		if (!cond->fun (test_cell ? test_cell->value : empty, cond))
+			return FALSE;
+	}
+
+	return TRUE;
+}
+
+static gboolean
+db_row_matches_any (Sheet *sheet, int row, GSList const *criterias)
+{
+	if (criterias == NULL)
+		return TRUE;
+
+	for (; criterias != NULL; criterias = criterias->next) {
+		GnmDBCriteria const *crit = criterias->data;
+		if (db_row_matches (sheet, row, crit->conditions))
+			return TRUE;
+	}
+
+	return FALSE;
+}
+
 /**
  * find_rows_that_match:
  * @sheet: #Sheet
@@ -532,34 +578,12 @@ find_rows_that_match (Sheet *sheet, int first_col, int first_row,
 		      GSList *criterias, gboolean unique_only)
 {
 	GSList	     *rows = NULL;
-	GSList const *crit_ptr, *cond_ptr;
 	int        row;
-	gboolean   add_flag;
 	char const *t1, *t2;
 	GnmCell   *test_cell;
-	GnmValue const *empty = value_new_empty ();
 
 	for (row = first_row; row <= last_row; row++) {
-		add_flag = TRUE;
-		for (crit_ptr = criterias; crit_ptr; crit_ptr = crit_ptr->next) {
-			GnmDBCriteria const *crit = crit_ptr->data;
-			add_flag = TRUE;
-			for (cond_ptr = crit->conditions;
-			     cond_ptr != NULL ; cond_ptr = cond_ptr->next) {
-				GnmCriteria *cond = cond_ptr->data;
-				test_cell = sheet_cell_get (sheet, cond->column, row);
-				if (test_cell != NULL)
-					gnm_cell_eval (test_cell);
-				if (!cond->fun (test_cell ? test_cell->value : empty, cond)) {
-					add_flag = FALSE;
-					break;
-				}
-			}
-
-			if (add_flag)
-				break;
-		}
-		if (add_flag) {
+		if (db_row_matches_any (sheet, row, criterias)) {
 			if (unique_only) {
 				GSList *c;
 				GnmCell   *cell;
@@ -599,6 +623,350 @@ filter_row:
 }
 
 /****************************************************************************/
+/*
+ * Equality indexes for the *IFS functions.
+ *
+ * Dashboards often have thousands of *IFS cells testing the same criteria
+ * ranges for equality against different values.  When such a range is
+ * seen for the second time during a recalc, we build a hash index from
+ * value to the positions that would pass criteria_test_equal.  Like the
+ * collect caches, the indexes are dropped at the end of each recalc.
+ */
+
+typedef struct {
+	/* key */
+	GnmValue *range;
+	GODateConventions const *date_conv;
+
+	unsigned uses;
+	gboolean indexed, building;
+	GHashTable *floats;	/* gnm_float * -> GArray of guint32 offsets */
+	GHashTable *strings;	/* ASCII-lowercased string -> GArray */
+	GArray *bools[2];
+} CritIndex;
+
+/* Ranges smaller than this are not indexed.  */
+#define CRIT_INDEX_MIN_SIZE 100
+
+static gulong crit_cache_handler;
+static GHashTable *crit_indexes;
+static GHashTable *db_views;
+static size_t crit_caches_size;
+static int crit_caches_busy;	/* Building; do not prune.  */
+
+static guint
+crit_float_hash (gconstpointer key)
+{
+	double d = *(gnm_float const *)key;
+	return g_double_hash (&d);
+}
+
+static gboolean
+crit_float_equal (gconstpointer a, gconstpointer b)
+{
+	return *(gnm_float const *)a == *(gnm_float const *)b;
+}
+
+/* Keyed on shared GOStrings, ignoring ASCII case like criteria_test_equal. */
+static guint
+crit_string_hash (gconstpointer key)
+{
+	unsigned char const *p = (unsigned char const *)((GOString const *)key)->str;
+	guint h = 5381;
+
+	for (; *p; p++)
+		h = (h << 5) + h + g_ascii_tolower (*p);
+	return h;
+}
+
+static gboolean
+crit_string_equal (gconstpointer a, gconstpointer b)
+{
+	return a == b ||
+		g_ascii_strcasecmp (((GOString const *)a)->str,
+				    ((GOString const *)b)->str) == 0;
+}
+
+static void
+crit_index_free (CritIndex *ci)
+{
+	value_release (ci->range);
+	if (ci->floats)
+		g_hash_table_destroy (ci->floats);
+	if (ci->strings)
+		g_hash_table_destroy (ci->strings);
+	if (ci->bools[0])
+		g_array_unref (ci->bools[0]);
+	if (ci->bools[1])
+		g_array_unref (ci->bools[1]);
+	g_free (ci);
+}
+
+static guint
+crit_index_hash (CritIndex const *ci)
+{
+	return value_hash (ci->range) ^ GPOINTER_TO_UINT (ci->date_conv);
+}
+
+static gboolean
+crit_index_equal (CritIndex const *a, CritIndex const *b)
+{
+	return a->date_conv == b->date_conv &&
+		value_equal (a->range, b->range);
+}
+
+static void db_view_free (gpointer view);
+static guint db_view_hash (gconstpointer view);
+static gboolean db_view_equal (gconstpointer a, gconstpointer b);
+
+static void
+crit_caches_clear (void)
+{
+	if (!crit_cache_handler)
+		return;
+
+	g_signal_handler_disconnect (gnm_app_get_app (), crit_cache_handler);
+	crit_cache_handler = 0;
+
+	g_hash_table_destroy (crit_indexes);
+	crit_indexes = NULL;
+	g_hash_table_destroy (db_views);
+	db_views = NULL;
+	crit_caches_size = 0;
+}
+
+static void
+crit_caches_create (void)
+{
+	if (crit_cache_handler)
+		return;
+
+	crit_cache_handler =
+		g_signal_connect (gnm_app_get_app (), "recalc-clear-caches",
+				  G_CALLBACK (crit_caches_clear), NULL);
+	crit_indexes = g_hash_table_new_full
+		((GHashFunc)crit_index_hash,
+		 (GEqualFunc)crit_index_equal,
+		 (GDestroyNotify)crit_index_free,
+		 NULL);
+	db_views = g_hash_table_new_full
+		(db_view_hash, db_view_equal, db_view_free, NULL);
+	crit_caches_size = 0;
+}
+
+static void
+crit_index_add (GHashTable *h, gpointer key, guint32 offset,
+		GDestroyNotify key_free)
+{
+	GArray *a = g_hash_table_lookup (h, key);
+	if (a) {
+		if (key_free)
+			key_free (key);
+	} else {
+		a = g_array_new (FALSE, FALSE, sizeof (guint32));
+		g_hash_table_insert (h, key, a);
+	}
+	g_array_append_val (a, offset);
+}
+
+static void
+crit_index_build (CritIndex *ci, GnmValue const *data, int sx, int sy,
+		  GnmEvalPos const *ep)
+{
+	GnmCriteria coerce;
+	int x, y;
+
+	/* Used to coerce values the way a numeric criterion would.  */
+	memset (&coerce, 0, sizeof (coerce));
+	coerce.x = value_new_float (0);
+	coerce.date_conv = ci->date_conv;
+
+	ci->floats = g_hash_table_new_full
+		(crit_float_hash, crit_float_equal,
+		 g_free, (GDestroyNotify)g_array_unref);
+	ci->strings = g_hash_table_new_full
+		(crit_string_hash, crit_string_equal,
+		 (GDestroyNotify)go_string_unref,
+		 (GDestroyNotify)g_array_unref);
+	ci->bools[0] = g_array_new (FALSE, FALSE, sizeof (guint32));
+	ci->bools[1] = g_array_new (FALSE, FALSE, sizeof (guint32));
+
+	for (y = 0; y < sy; y++) {
+		for (x = 0; x < sx; x++) {
+			GnmValue const *v = value_area_get_x_y (data, x, y, ep);
+			guint32 offset = y * sx + x;
+			gnm_float xf, yf;
+
+			if (v == NULL)
+				continue;
+
+			if (VALUE_IS_BOOLEAN (v)) {
+				int b = value_get_as_float (v) != 0;
+				g_array_append_val (ci->bools[b], offset);
+				continue;
+			}
+
+			if (VALUE_IS_STRING (v))
+				crit_index_add (ci->strings,
+						go_string_ref (v->v_str.val),
+						offset,
+						(GDestroyNotify)go_string_unref);
+
+			if (criteria_inspect_values (v, &xf, &yf, &coerce, TRUE) == CRIT_FLOAT) {
+				gnm_float *key = g_new (gnm_float, 1);
+				*key = (xf == 0) ? 0 : xf;	/* No -0 */
+				crit_index_add (ci->floats, key, offset, g_free);
+			}
+		}
+	}
+
+	value_release (coerce.x);
+	ci->indexed = TRUE;
+}
+
+/*
+ * Look up, or register a use of, the index for @data.  Returns the index
+ * only once it has been built.
+ */
+static CritIndex *
+crit_index_get (GnmValue const *data, int sx, int sy,
+		GODateConventions const *date_conv, GnmEvalPos const *ep)
+{
+	CritIndex key, *ci;
+	GnmSheetRange sr;
+	Sheet *end_sheet;
+
+	if (!VALUE_IS_CELLRANGE (data) || sx * sy < CRIT_INDEX_MIN_SIZE)
+		return NULL;
+
+	gnm_rangeref_normalize (value_get_rangeref (data), ep,
+				&sr.sheet, &end_sheet, &sr.range);
+	if (sr.sheet != end_sheet)
+		return NULL; /* 3D */
+
+	crit_caches_create ();
+
+	key.range = value_new_cellrange_r (sr.sheet, &sr.range);
+	key.date_conv = date_conv;
+	ci = g_hash_table_lookup (crit_indexes, &key);
+	if (!ci) {
+		ci = g_new0 (CritIndex, 1);
+		ci->range = key.range;
+		ci->date_conv = date_conv;
+		g_hash_table_insert (crit_indexes, ci, ci);
+	} else
+		value_release (key.range);
+
+	if (ci->indexed)
+		return ci;
+
+	if (++ci->uses < 2 || ci->building)
+		return NULL;
+
+	if (crit_caches_size > GNM_DEFAULT_ROWS * 32) {
+		if (crit_caches_busy)
+			return NULL;
+		/* Pruning frees ci, so start over.  */
+		crit_caches_clear ();
+		return NULL;
+	}
+
+	/* Building evaluates cells, which may get here recursively.  */
+	crit_caches_busy++;
+	ci->building = TRUE;
+	crit_index_build (ci, data, sx, sy, ep);
+	ci->building = FALSE;
+	crit_caches_busy--;
+	crit_caches_size += sx * sy;
+	return ci;
+}
+
+/*
+ * Find the positions in @ci that can pass @crit.  Returns FALSE if @crit
+ * cannot be answered from the index.  Otherwise *cands receives a new
+ * reference to the candidate offsets, in increasing order.  (Evaluating
+ * the candidates can prune the caches, hence the reference.)
+ */
+static gboolean
+crit_index_probe (CritIndex const *ci, GnmCriteria const *crit,
+		  GArray **cands)
+{
+	GnmValue const *y = crit->x;
+	GArray *a = NULL;
+
+	if (crit->fun != criteria_test_equal || y == NULL)
+		return FALSE;
+
+	switch (y->v_any.type) {
+	case VALUE_BOOLEAN:
+		a = ci->bools[value_get_as_float (y) != 0];
+		break;
+
+	case VALUE_FLOAT: {
+		gnm_float yf = value_get_as_float (y);
+		if (yf == 0) yf = 0;	/* No -0 */
+		a = g_hash_table_lookup (ci->floats, &yf);
+		break;
+	}
+
+	case VALUE_STRING:
+		a = g_hash_table_lookup (ci->strings, y->v_str.val);
+		break;
+
+	case VALUE_EMPTY:
+		break;
+
+	default:
+		return FALSE;
+	}
+
+	*cands = a
+		? g_array_ref (a)
+		: g_array_new (FALSE, FALSE, sizeof (guint32));
+	return TRUE;
+}
+
+/*
+ * Test all criteria at (x,y) and collect the value if they match.  Returns
+ * an error value if the collection must stop.
+ */
+static GnmValue *
+gnm_ifs_collect (GPtrArray *data, GPtrArray *crits, GnmValue const *vals,
+		 int x, int y, GnmEvalPos const *ep, CollectFlags flags,
+		 GArray *xs)
+{
+	GnmValue const *v;
+	unsigned ui;
+	gnm_float f;
+
+	for (ui = 0; ui < crits->len; ui++) {
+		GnmCriteria *crit = g_ptr_array_index (crits, ui);
+		GnmValue const *datai = g_ptr_array_index (data, ui);
+		v = value_area_get_x_y (datai, x, y, ep);
+
+		if (!crit->fun (v, crit))
+			return NULL;
+	}
+
+	// Match.  Maybe collect the data point.
+
+	v = value_area_get_x_y (vals, x, y, ep);
+	if ((flags & COLLECT_IGNORE_STRINGS) && VALUE_IS_STRING (v))
+		return NULL;
+	if ((flags & COLLECT_IGNORE_BOOLS) && VALUE_IS_BOOLEAN (v))
+		return NULL;
+	if ((flags & COLLECT_IGNORE_BLANKS) && VALUE_IS_EMPTY (v))
+		return NULL;
+	if ((flags & COLLECT_IGNORE_ERRORS) && VALUE_IS_ERROR (v))
+		return NULL;
+
+	if (VALUE_IS_ERROR (v))
+		return value_dup (v);
+
+	f = value_get_as_float (v);
+	g_array_append_val (xs, f);
+	return NULL;
+}
 
 /**
  * gnm_ifs_func:
@@ -623,8 +991,9 @@ gnm_ifs_func (GPtrArray *data, GPtrArray *crits, GnmValue const *vals,
 	      GnmEvalPos const *ep, CollectFlags flags)
 {
 	int sx, sy, x, y;
-	unsigned ui, N = 0, nalloc = 0;
-	gnm_float *xs = NULL;
+	unsigned ui;
+	GArray *cand = NULL;
+	GArray *xs;
 	GnmValue *res = NULL;
 	gnm_float fres;
 
@@ -646,54 +1015,274 @@ gnm_ifs_func (GPtrArray *data, GPtrArray *crits, GnmValue const *vals,
 			return value_new_error_VALUE (ep);
 	}
 
-	for (y = 0; y < sy; y++) {
-		for (x = 0; x < sx; x++) {
-			GnmValue const *v;
-			gboolean match = TRUE;
-
-			for (ui = 0; match && ui < crits->len; ui++) {
-				GnmCriteria *crit = g_ptr_array_index (crits, ui);
-				GnmValue const *datai = g_ptr_array_index (data, ui);
-				v = value_area_get_x_y (datai, x, y, ep);
-
-				match = crit->fun (v, crit);
-			}
-			if (!match)
-				continue;
-
-			// Match.  Maybe collect the data point.
+	/* Use the most selective equality index, if any.  */
+	for (ui = 0; ui < crits->len; ui++) {
+		GnmCriteria *crit = g_ptr_array_index (crits, ui);
+		GnmValue const *datai = g_ptr_array_index (data, ui);
+		GArray *a;
+		CritIndex *ci;
 
-			v = value_area_get_x_y (vals, x, y, ep);
-			if ((flags & COLLECT_IGNORE_STRINGS) && VALUE_IS_STRING (v))
-				continue;
-			if ((flags & COLLECT_IGNORE_BOOLS) && VALUE_IS_BOOLEAN (v))
-				continue;
-			if ((flags & COLLECT_IGNORE_BLANKS) && VALUE_IS_EMPTY (v))
-				continue;
-			if ((flags & COLLECT_IGNORE_ERRORS) && VALUE_IS_ERROR (v))
-				continue;
+		if (crit->fun != criteria_test_equal)
+			continue;
+		ci = crit_index_get (datai, sx, sy, crit->date_conv, ep);
+		if (!ci || !crit_index_probe (ci, crit, &a))
+			continue;
+		if (cand == NULL || a->len < cand->len) {
+			if (cand)
+				g_array_unref (cand);
+			cand = a;
+		} else
+			g_array_unref (a);
+	}
 
-			if (VALUE_IS_ERROR (v)) {
-				res = value_dup (v);
-				goto out;
-			}
+	xs = g_array_new (FALSE, FALSE, sizeof (gnm_float));
 
-			if (N >= nalloc) {
-				nalloc = (2 * nalloc) + 100;
-				xs = g_renew (gnm_float, xs, nalloc);
-			}
-			xs[N++] = value_get_as_float (v);
+	if (cand) {
+		for (ui = 0; ui < cand->len && !res; ui++) {
+			guint32 o = g_array_index (cand, guint32, ui);
+			res = gnm_ifs_collect (data, crits, vals,
+					       o % sx, o / sx,
+					       ep, flags, xs);
 		}
+	} else {
+		for (y = 0; y < sy && !res; y++)
+			for (x = 0; x < sx && !res; x++)
+				res = gnm_ifs_collect (data, crits, vals,
+						       x, y, ep, flags, xs);
 	}
 
-	if (fun (xs, N, &fres)) {
+	if (res)
+		goto out;
+
+	if (fun ((gnm_float *)xs->data, xs->len, &fres)) {
 		res = value_new_error_std (ep, err);
 	} else
 		res = value_new_float (fres);
 
 out:
-	g_free (xs);
+	if (cand)
+		g_array_unref (cand);
+	g_array_free (xs, TRUE);
 	return res;
 }
 
 /****************************************************************************/
+/*
+ * Matching rows for the database functions.
+ *
+ * A view records, for a database range and a criteria range, which
+ * records match.  All D* calls with the same two ranges share it, whatever
+ * field they aggregate, so the criteria are parsed and the fields resolved
+ * once per recalc.  Alternatives with an equality condition are answered
+ * from the indexes above.
+ */
+
+typedef struct {
+	/* key */
+	GnmValue *database;
+	GnmValue *criteria;
+
+	GArray *rows;		/* NULL if the criteria are invalid */
+} DbView;
+
+static void
+db_view_free (gpointer view_)
+{
+	DbView *view = view_;
+	value_release (view->database);
+	value_release (view->criteria);
+	if (view->rows)
+		g_array_unref (view->rows);
+	g_free (view);
+}
+
+static guint
+db_view_hash (gconstpointer view_)
+{
+	DbView const *view = view_;
+	return value_hash (view->database) * 31 + value_hash (view->criteria);
+}
+
+static gboolean
+db_view_equal (gconstpointer a_, gconstpointer b_)
+{
+	DbView const *a = a_, *b = b_;
+	return value_equal (a->database, b->database) &&
+		value_equal (a->criteria, b->criteria);
+}
+
+static GnmValue *
+db_range_key (GnmValue const *v, GnmEvalPos const *ep)
+{
+	GnmRange r;
+	Sheet *start_sheet, *end_sheet;
+
+	gnm_rangeref_normalize (value_get_rangeref (v), ep,
+				&start_sheet, &end_sheet, &r);
+	return value_new_cellrange_r (start_sheet, &r);
+}
+
+/*
+ * The offsets, relative to @first_row, of the rows that can pass
+ * @conditions, or NULL if no condition can be answered from an index.
+ */
+static GArray *
+db_probe_conditions (Sheet *sheet, int first_row, int last_row,
+		     GSList const *conditions, GnmEvalPos const *ep)
+{
+	GArray *best = NULL;
+
+	for (; conditions != NULL; conditions = conditions->next) {
+		GnmCriteria *cond = conditions->data;
+		GnmRange r;
+		GnmValue *data;
+		CritIndex *ci;
+		GArray *a;
+
+		if (cond->fun != criteria_test_equal)
+			continue;
+
+		range_init (&r, cond->column, first_row,
+			    cond->column, last_row);
+		data = value_new_cellrange_r (sheet, &r);
+		ci = crit_index_get (data, 1, range_height (&r),
+				     cond->date_conv, ep);
+		value_release (data);
+
+		if (!ci || !crit_index_probe (ci, cond, &a))
+			continue;
+		if (best == NULL || a->len < best->len) {
+			if (best)
+				g_array_unref (best);
+			best = a;
+		} else
+			g_array_unref (a);
+	}
+
+	return best;
+}
+
+static GArray *
+db_match_rows (Sheet *sheet, int first_row, int last_row,
+	       GSList const *criterias, GnmEvalPos const *ep)
+{
+	GArray *rows = g_array_new (FALSE, FALSE, sizeof (int));
+	GPtrArray *cands = g_ptr_array_new_with_free_func
+		((GDestroyNotify)g_array_unref);
+	GSList const *l;
+	int row;
+	unsigned ui, uj;
+
+	/* All alternatives need an index for it to pay off.  */
+	for (l = criterias; l && first_row <= last_row; l = l->next) {
+		GnmDBCriteria const *crit = l->data;
+		GArray *a = db_probe_conditions (sheet, first_row, last_row,
+						 crit->conditions, ep);
+		if (!a)
+			break;
+		g_ptr_array_add (cands, a);
+	}
+
+	if (criterias == NULL || l != NULL) {
+		for (row = first_row; row <= last_row; row++)
+			if (db_row_matches_any (sheet, row, criterias))
+				g_array_append_val (rows, row);
+	} else if (cands->len == 1) {
+		GArray *a = g_ptr_array_index (cands, 0);
+		GnmDBCriteria const *crit = criterias->data;
+
+		for (uj = 0; uj < a->len; uj++) {
+			row = first_row + g_array_index (a, guint32, uj);
+			if (db_row_matches (sheet, row, crit->conditions))
+				g_array_append_val (rows, row);
+		}
+	} else {
+		/* Union of the alternatives, kept in row order.  */
+		guint8 *hit = g_new0 (guint8, last_row - first_row + 1);
+
+		for (l = criterias, ui = 0; l; l = l->next, ui++) {
+			GnmDBCriteria const *crit = l->data;
+			GArray *a = g_ptr_array_index (cands, ui);
+
+			for (uj = 0; uj < a->len; uj++) {
+				guint32 o = g_array_index (a, guint32, uj);
+				if (!hit[o] &&
+				    db_row_matches (sheet, first_row + o,
+						    crit->conditions))
+					hit[o] = 1;
+			}
+		}
+
+		for (row = first_row; row <= last_row; row++)
+			if (hit[row - first_row])
+				g_array_append_val (rows, row);
+		g_free (hit);
+	}
+
+	g_ptr_array_free (cands, TRUE);
+	return rows;
+}
+
+/**
+ * gnm_database_matching_rows:
+ * @ep: #GnmEvalPos
+ * @database: #GnmValue
+ * @criteria: #GnmValue
+ *
+ * Finds the records of @database, not counting its header row, that match
+ * @criteria.  The result is shared with other calls for the same ranges
+ * during the current recalc.
+ *
+ * Returns: (element-type int) (transfer full) (nullable): the matching
+ * rows, in increasing order, or %NULL if @criteria is invalid.
+ */
+GArray *
+gnm_database_matching_rows (GnmEvalPos const *ep,
+			    GnmValue const *database,
+			    GnmValue const *criteria)
+{
+	DbView key, *view;
+	GSList *criterias;
+	Sheet *sheet;
+
+	g_return_val_if_fail (VALUE_IS_CELLRANGE (database), NULL);
+	g_return_val_if_fail (VALUE_IS_CELLRANGE (criteria), NULL);
+
+	crit_caches_create ();
+
+	key.database = db_range_key (database, ep);
+	key.criteria = db_range_key (criteria, ep);
+	view = g_hash_table_lookup (db_views, &key);
+	if (view) {
+		value_release (key.database);
+		value_release (key.criteria);
+		return view->rows ? g_array_ref (view->rows) : NULL;
+	}
+
+	/* Matching evaluates cells, so insert only when done.  */
+	view = g_new (DbView, 1);
+	view->database = key.database;
+	view->criteria = key.criteria;
+	criterias = parse_database_criteria (ep, database, criteria);
+	if (criterias) {
+		sheet = eval_sheet (database->v_range.cell.a.sheet, ep->sheet);
+		view->rows = db_match_rows (sheet,
+					    database->v_range.cell.a.row + 1,
+					    database->v_range.cell.b.row,
+					    criterias, ep);
+		free_criterias (criterias);
+	} else
+		view->rows = NULL;
+
+	/* Evaluation may have pruned the caches.  */
+	if (crit_caches_size > GNM_DEFAULT_ROWS * 32 && !crit_caches_busy)
+		crit_caches_clear ();
+	crit_caches_create ();
+	if (view->rows)
+		crit_caches_size += view->rows->len;
+	g_hash_table_replace (db_views, view, view);
+
+	return view->rows ? g_array_ref (view->rows) : NULL;
+}
+
+/****************************************************************************/
@@ -48,6 +48,9 @@ GSList *parse_database_criteria (GnmEvalPos const *ep,
 				 GnmValue const *database, GnmValue const *criteria);
 int     find_column_of_field	(GnmEvalPos const *ep,
 				 GnmValue const *database, GnmValue const *field);
+GArray *gnm_database_matching_rows (GnmEvalPos const *ep,
+				    GnmValue const *database,
+				    GnmValue const *criteria);
 
 GnmValue *gnm_ifs_func (GPtrArray *data, GPtrArray *crits, GnmValue const *vals,
 			float_range_function_t fun, GnmStdError err,
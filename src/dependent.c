@@ -642,6 +642,15 @@ typedef struct {
 #define MICRO_HASH_MIN_SIZE 11
 #define MICRO_HASH_MAX_SIZE 13845163
 
+/*
+ * Besides the one, few and many forms a MicroHash with more than
+ * MICRO_HASH_FEW elements can be packed: u.few then holds exactly
+ * num_elements pointers and num_buckets is 0.  Packing is done by
+ * gnm_dep_container_compact for graphs that are not expected to change.
+ * Any change, insertion or removal, goes back to many first.
+ */
+#define micro_hash_is_packed(h) ((h)->num_elements > MICRO_HASH_FEW && (h)->num_buckets == 0)
+
 #define MICRO_HASH_hash(key) ((guint)GPOINTER_TO_UINT(key))
 
 static void
@@ -715,6 +724,54 @@ micro_hash_many_resize (MicroHash *hash_table, int new_nbuckets)
 }
 
 
+static void
+micro_hash_pack (MicroHash *hash_table)
+{
+	CSet **buckets = hash_table->u.many;
+	int nbuckets = hash_table->num_buckets;
+	int i = 0;
+
+	if (hash_table->num_elements <= MICRO_HASH_FEW ||
+	    micro_hash_is_packed (hash_table))
+		return;
+
+	hash_table->u.few = g_new (gpointer, hash_table->num_elements);
+	hash_table->num_buckets = 0;
+
+	while (nbuckets-- > 0) {
+		gpointer datum;
+
+		CSET_FOREACH (buckets[nbuckets], datum, {
+			hash_table->u.few[i++] = datum;
+		});
+		cset_free (buckets[nbuckets]);
+	}
+
+	g_free (buckets);
+}
+
+static void
+micro_hash_unpack (MicroHash *hash_table)
+{
+	gpointer *packed = hash_table->u.few;
+	int N = hash_table->num_elements;
+	int nbuckets = g_spaced_primes_closest (N / (CSET_SEGMENT_SIZE / 2));
+	CSet **buckets;
+	int i;
+
+	nbuckets = CLAMP (nbuckets, MICRO_HASH_MIN_SIZE, MICRO_HASH_MAX_SIZE);
+	buckets = g_new0 (CSet *, nbuckets);
+
+	for (i = 0; i < N; i++) {
+		guint bucket = MICRO_HASH_hash (packed[i]) % nbuckets;
+		cset_insert (&(buckets[bucket]), packed[i]);
+	}
+	g_free (packed);
+
+	hash_table->u.many = buckets;
+	hash_table->num_buckets = nbuckets;
+}
+
 static void
 micro_hash_few_to_many (MicroHash *hash_table)
 {
@@ -767,9 +824,16 @@ micro_hash_insert (MicroHash *hash_table, gpointer key)
 		} else
 			hash_table->u.few[N] = key;
 	} else {
-		int nbuckets = hash_table->num_buckets;
-		guint bucket = MICRO_HASH_hash (key) % nbuckets;
-		CSet **buckets = hash_table->u.many;
+		int nbuckets;
+		guint bucket;
+		CSet **buckets;
+
+		if (micro_hash_is_packed (hash_table))
+			micro_hash_unpack (hash_table);
+
+		nbuckets = hash_table->num_buckets;
+		bucket = MICRO_HASH_hash (key) % nbuckets;
+		buckets = hash_table->u.many;
 
 		if (cset_insert_checked (&(buckets[bucket]), key))
 			return;
@@ -821,6 +885,10 @@ micro_hash_remove (MicroHash *hash_table, gpointer key)
 		return;
 	}
 
+	/* A set being edited is not static; go back to buckets.  */
+	if (micro_hash_is_packed (hash_table))
+		micro_hash_unpack (hash_table);
+
 	bucket = MICRO_HASH_hash (key) % hash_table->num_buckets;
 	if (cset_remove (&(hash_table->u.many[bucket]), key)) {
 		hash_table->num_elements--;
@@ -844,6 +912,8 @@ micro_hash_release (MicroHash *hash_table)
 		; /* Nothing */
 	else if (N <= MICRO_HASH_FEW)
 		FREE_FEW (hash_table->u.few);
+	else if (micro_hash_is_packed (hash_table))
+		g_free (hash_table->u.few);
 	else {
 		guint i = hash_table->num_buckets;
 		while (i-- > 0)
@@ -872,7 +942,7 @@ micro_hash_is_empty (MicroHash const *hash_table)
 
 #define micro_hash_foreach_dep(dc, dep, code) do {			\
 	guint i_ = dc.num_elements;					\
-	if (i_ <= MICRO_HASH_FEW) {					\
+	if (i_ <= MICRO_HASH_FEW || dc.num_buckets == 0) {		\
 		const gpointer *e_ = (i_ == 1) ? &dc.u.one : dc.u.few;	\
 		while (i_-- > 0) {					\
 			GnmDependent *dep = e_[i_];			\
@@ -2250,9 +2320,21 @@ cb_single_contained_collect (DependencySingle const *depsingle,
 			}});
 }
 
+static GnmValue *
+cb_cell_contained_collect (GnmCellIter const *iter, CollectClosure *user)
+{
+	GnmDependent *dep = GNM_CELL_TO_DEP (iter->cell);
+
+	if (gnm_cell_has_expr (iter->cell) && dependent_is_linked (dep)) {
+		dep->flags |= DEPENDENT_FLAGGED;
+		user->list = g_slist_prepend (user->list, dep);
+	}
+	return NULL;
+}
+
 struct cb_remote_names {
 	GSList *names;
-	Workbook *wb;
+	Sheet *sheet;
 };
 
 static void
@@ -2268,17 +2350,17 @@ cb_remote_names2 (GnmNamedExpr *nexpr,
 		  G_GNUC_UNUSED gpointer value,
 		  struct cb_remote_names *data)
 {
-	Workbook *wb =
-		nexpr->pos.sheet ? nexpr->pos.sheet->workbook : nexpr->pos.wb;
-	if (wb != data->wb)
+	/* Names local to the sheet are already in the list.  */
+	if (nexpr->pos.sheet != data->sheet)
 		data->names = g_slist_prepend (data->names, nexpr);
 }
 
 /*
  * Get a list of all names that (may) reference data in a given sheet.
- * This is approximated as all names in the sheet, all global names in
- * its workbook, and all external references that actually mention the
- * sheet explicitly.
+ * This is approximated as all names in the sheet and all other names that
+ * actually mention the sheet explicitly.  Sheet-less references in global
+ * names never relocate, so there is no need to look at all the global
+ * names of the workbook.
  */
 static GSList *
 names_referencing_sheet (Sheet *sheet)
@@ -2286,11 +2368,8 @@ names_referencing_sheet (Sheet *sheet)
 	struct cb_remote_names data;
 
 	data.names = NULL;
-	data.wb = sheet->workbook;
+	data.sheet = sheet;
 
-	workbook_foreach_name (sheet->workbook, TRUE,
-			       (GHFunc)cb_remote_names1,
-			       &data);
 	gnm_sheet_foreach_name (sheet, (GHFunc)cb_remote_names1, &data);
 
 	if (sheet->deps->referencing_names)
@@ -2312,6 +2391,21 @@ names_referencing_sheet (Sheet *sheet)
  **/
 GOUndo *
 dependents_relocate (GnmExprRelocateInfo const *rinfo)
+{
+	return dependents_relocate_size (rinfo, NULL);
+}
+
+/**
+ * dependents_relocate_size:
+ * @info: the descriptor record for what is being moved where.
+ * @psize: (out) (optional): the size, in undo units, of what was saved
+ *
+ * As dependents_relocate.  Each saved expression and name is one unit.
+ * Returns: (transfer full): a list of the locations and expressions that were changed outside of
+ * the region.
+ **/
+GOUndo *
+dependents_relocate_size (GnmExprRelocateInfo const *rinfo, gint64 *psize)
 {
 	GnmExprRelocateInfo local_rinfo;
 	GSList    *l, *dependents = NULL, *undo_info = NULL;
@@ -2320,6 +2414,9 @@ dependents_relocate (GnmExprRelocateInfo const *rinfo)
 	int i;
 	CollectClosure collect;
 	GOUndo *u_exprs, *u_names;
+	gint64 size = 0;
+
+	if (psize) *psize = 0;
 
 	g_return_val_if_fail (rinfo != NULL, NULL);
 
@@ -2331,22 +2428,32 @@ dependents_relocate (GnmExprRelocateInfo const *rinfo)
 	sheet = rinfo->origin_sheet;
 	r     = &rinfo->origin;
 
-	/* collect contained cells with expressions */
-	SHEET_FOREACH_DEPENDENT (rinfo->origin_sheet, dep, {
-		GnmCell *cell = GNM_DEP_TO_CELL (dep);
-		if (dependent_is_cell (dep) &&
-		    range_contains (r, cell->pos.col, cell->pos.row)) {
-			dependents = g_slist_prepend (dependents, dep);
-			dep->flags |= DEPENDENT_FLAGGED;
-		}
-	});
-
-	/* collect the things that depend on source region */
+	/* collect contained cells with expressions.  The cell storage is
+	 * our spatial index of formula positions; for a large range it
+	 * falls back to scanning all cells.  */
 	collect.target = r;
-	collect.list = dependents;
-	g_hash_table_foreach (sheet->deps->single_hash,
-		(GHFunc) &cb_single_contained_collect,
-		(gpointer)&collect);
+	collect.list = NULL;
+	sheet_foreach_cell_in_range (sheet, CELL_ITER_IGNORE_NONEXISTENT, r,
+				     (CellIterFunc)cb_cell_contained_collect,
+				     &collect);
+
+	/* collect the things that depend on source region.  Probe the
+	 * positions of a small region rather than scanning every single
+	 * reference on the sheet.  */
+	if ((gint64)range_width (r) * range_height (r) <
+	    (gint64)g_hash_table_size (sheet->deps->single_hash)) {
+		DependencySingle lookup, *single;
+
+		for (lookup.pos.row = r->start.row; lookup.pos.row <= r->end.row; lookup.pos.row++)
+			for (lookup.pos.col = r->start.col; lookup.pos.col <= r->end.col; lookup.pos.col++) {
+				single = g_hash_table_lookup (sheet->deps->single_hash, &lookup);
+				if (single)
+					cb_single_contained_collect (single, NULL, &collect);
+			}
+	} else
+		g_hash_table_foreach (sheet->deps->single_hash,
+			(GHFunc) &cb_single_contained_collect,
+			(gpointer)&collect);
 	{
 		int const first = bucket_of_row (r->start.row);
 		GHashTable *hash;
@@ -2370,8 +2477,12 @@ dependents_relocate (GnmExprRelocateInfo const *rinfo)
 		parse_pos_init_dep (&local_rinfo.pos, dep);
 
 		/* it is possible nothing changed for contained deps
-		 * using absolute references */
-		newtree = gnm_expr_top_relocate (dep->texpr, &local_rinfo, FALSE);
+		 * using absolute references.  Nor for contained deps that
+		 * only shift along with everything they reference, which we
+		 * can tell without walking the expression.  */
+		newtree = gnm_expr_top_relocate_is_shift (dep->texpr, &local_rinfo)
+			? NULL
+			: gnm_expr_top_relocate (dep->texpr, &local_rinfo, FALSE);
 		if (newtree != NULL) {
 			int const t = dependent_type (dep);
 			ExprRelocateStorage *tmp =
@@ -2388,6 +2499,7 @@ dependents_relocate (GnmExprRelocateInfo const *rinfo)
 				tmp->oldtree = dep->texpr;
 				gnm_expr_top_ref (tmp->oldtree);
 				undo_info = g_slist_prepend (undo_info, tmp);
+				size++;
 
 				dependent_set_expr (dep, newtree); /* unlinks */
 				gnm_expr_top_unref (newtree);
@@ -2450,6 +2562,7 @@ dependents_relocate (GnmExprRelocateInfo const *rinfo)
 				GOUndo *u = expr_name_set_expr_undo_new (nexpr);
 				u_names = go_undo_combine (u_names, u);
 				expr_name_set_expr (nexpr, newtree);
+				size++;
 			}
 		}
 		g_slist_free (names);
@@ -2460,6 +2573,7 @@ dependents_relocate (GnmExprRelocateInfo const *rinfo)
 	}
 	}
 
+	if (psize) *psize = size;
 	return go_undo_combine (u_exprs, u_names);
 }
 
@@ -3145,6 +3259,41 @@ gnm_dep_container_resize (GnmDepContainer *deps, int rows)
 	deps->buckets = buckets;
 }
 
+static void
+cb_dep_any_pack (DependencyAny *depany,
+		 G_GNUC_UNUSED gpointer value,
+		 G_GNUC_UNUSED gpointer user)
+{
+	micro_hash_pack (&depany->deps);
+}
+
+/**
+ * gnm_dep_container_compact:
+ * @deps: #GnmDepContainer
+ *
+ * Store the larger sets of dependents in @deps as exactly-sized arrays.
+ * This saves memory when the dependency graph is not expected to change
+ * much, e.g., after a file has been loaded.  A set reverts to its hashed
+ * form when a dependent is added to it.
+ */
+void
+gnm_dep_container_compact (GnmDepContainer *deps)
+{
+	int i;
+
+	g_return_if_fail (deps != NULL);
+
+	for (i = 0; i < deps->buckets; i++) {
+		GHashTable *hash = deps->range_hash[i];
+		if (hash != NULL)
+			g_hash_table_foreach (hash, (GHFunc)cb_dep_any_pack, NULL);
+	}
+
+	if (deps->single_hash)
+		g_hash_table_foreach (deps->single_hash,
+				      (GHFunc)cb_dep_any_pack, NULL);
+}
+
 /****************************************************************************
  * Debug utils
  */
@@ -3279,6 +3428,55 @@ dump_dynamic_dep (GnmDependent *dep, DynamicDep *dyn, GHashTable *alldeps)
 	g_string_free (out.accum, TRUE);
 }
 
+typedef struct {
+	int entries, links, packed;
+	gsize bytes;
+} DepMemStats;
+
+/* Approximate, as it ignores allocator and GHashTable overhead.  */
+static void
+cb_dep_mem_stats (DependencyAny const *depany,
+		  G_GNUC_UNUSED gpointer value,
+		  DepMemStats *stats)
+{
+	MicroHash const *h = &depany->deps;
+	int N = h->num_elements;
+
+	stats->entries++;
+	stats->links += N;
+
+	if (N <= 1)
+		; /* Nothing */
+	else if (N <= MICRO_HASH_FEW)
+		stats->bytes += MICRO_HASH_FEW * sizeof (gpointer);
+	else if (micro_hash_is_packed (h)) {
+		stats->bytes += N * sizeof (gpointer);
+		stats->packed++;
+	} else {
+		int b;
+
+		stats->bytes += h->num_buckets * sizeof (CSet *);
+		for (b = 0; b < h->num_buckets; b++) {
+			CSet const *cs;
+			for (cs = h->u.many[b]; cs; cs = cs->next)
+				stats->bytes += sizeof (CSet);
+		}
+	}
+}
+
+static void
+dump_mem_stats (char const *what, GHashTable *hash, gsize entry_size)
+{
+	DepMemStats stats;
+
+	memset (&stats, 0, sizeof (stats));
+	g_hash_table_foreach (hash, (GHFunc)cb_dep_mem_stats, &stats);
+	stats.bytes += stats.entries * entry_size;
+
+	g_printerr ("  Memory for %s: %d entries, %d links, %d packed, about %" G_GSIZE_FORMAT " bytes\n",
+		    what, stats.entries, stats.links, stats.packed, stats.bytes);
+}
+
 /**
  * gnm_dep_container_dump:
  * @deps:
@@ -3310,6 +3508,7 @@ gnm_dep_container_dump (GnmDepContainer const *deps,
 				    bucket_start_row (i) + 1,
 				    bucket_end_row (i) + 1,
 				    g_hash_table_size (hash));
+			dump_mem_stats ("ranges", hash, sizeof (DependencyRange));
 			g_hash_table_iter_init (&hiter, hash);
 			while (g_hash_table_iter_next (&hiter, &key, NULL)) {
 				DependencyRange *deprange = key;
@@ -3324,6 +3523,8 @@ gnm_dep_container_dump (GnmDepContainer const *deps,
 
 		g_printerr ("  Single hash size %d: cell on which list of cells depend\n",
 			    g_hash_table_size (deps->single_hash));
+		dump_mem_stats ("singles", deps->single_hash,
+				sizeof (DependencySingle));
 
 		g_hash_table_iter_init (&hiter, deps->single_hash);
 		while (g_hash_table_iter_next (&hiter, &key, NULL)) {
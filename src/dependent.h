@@ -103,6 +103,8 @@ GnmCellPos const *dependent_pos (GnmDependent const *dep);
 void dependent_move (GnmDependent *dep, int dx, int dy);
 
 GOUndo  *dependents_relocate	    (GnmExprRelocateInfo const *info);
+GOUndo  *dependents_relocate_size   (GnmExprRelocateInfo const *info,
+				     gint64 *psize);
 void	 dependents_link	    (GSList *deps);
 
 void	 gnm_cell_eval		    (GnmCell *cell);
@@ -127,6 +129,7 @@ void		 gnm_dep_container_dump	(GnmDepContainer const *deps,
 void dependents_dump (Workbook *wb);
 void             gnm_dep_container_sanity_check (GnmDepContainer const *deps);
 void             gnm_dep_container_resize (GnmDepContainer *deps, int rows);
+void             gnm_dep_container_compact (GnmDepContainer *deps);
 
 // ----------------------------------------------------------------------------
 
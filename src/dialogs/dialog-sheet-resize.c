@@ -171,7 +171,7 @@ dialog_sheet_resize (WBCGtk *wbcg)
 	state->sheet = wbcg_cur_sheet (wbcg);
 	g_return_if_fail (state->dialog != NULL);
 
-	slider_width = mylog2 (MAX (GNM_MAX_ROWS / GNM_MIN_ROWS,
+	slider_width = mylog2 (MAX (gnm_sheet_max_rows_limit () / GNM_MIN_ROWS,
 				    GNM_MAX_COLS / GNM_MIN_COLS)) *
 		gnm_widget_measure_string (GTK_WIDGET (wbcg_toplevel (wbcg)),
 					   "00");
@@ -198,7 +198,7 @@ dialog_sheet_resize (WBCGtk *wbcg)
 				  state);
 	init_scale (state->rows_scale,
 		    gnm_sheet_get_max_rows (state->sheet),
-		    GNM_MIN_ROWS, GNM_MAX_ROWS);
+		    GNM_MIN_ROWS, gnm_sheet_max_rows_limit ());
 
 	cb_scale_changed (state);
 
@@ -140,7 +140,7 @@ main_page_import_range_changed (StfDialogData *data)
 	startrow = MIN (stoprow, MAX (1, startrow));
 
 	stoplimit = MIN ((int)renderdata->lines->len,
-			 startrow + (GNM_MAX_ROWS - 1));
+			 startrow + (gnm_sheet_max_rows_limit () - 1));
 	stoprow = MIN (stoprow, stoplimit);
 
 	gtk_spin_button_set_value (data->main.main_startrow, startrow);
@@ -511,6 +511,31 @@ gnm_named_expr_collection_foreach (GnmNamedExprCollection *names,
 
 /******************************************************************************/
 
+struct cb_name_references {
+	GnmNamedExpr *nexpr;
+	gboolean add;
+};
+
+static GnmExpr const *
+cb_name_references (GnmExpr const *expr, GnmExprWalk *data)
+{
+	struct cb_name_references *args = data->user;
+	GnmNamedExpr *used = (GnmNamedExpr *)gnm_expr_get_name (expr);
+
+	if (used == NULL || used == args->nexpr)
+		return NULL;
+
+	if (args->add) {
+		if (used->referencing_names == NULL)
+			used->referencing_names =
+				g_hash_table_new (g_direct_hash, g_direct_equal);
+		g_hash_table_add (used->referencing_names, args->nexpr);
+	} else if (used->referencing_names != NULL)
+		g_hash_table_remove (used->referencing_names, args->nexpr);
+
+	return NULL;
+}
+
 /**
  * expr_name_handle_references:
  *
@@ -518,11 +543,15 @@ gnm_named_expr_collection_foreach (GnmNamedExprCollection *names,
  * all of the sheets it explicitly references.  This is necessary
  * because names are not dependents, and if they reference a deleted
  * sheet we will not notice.
+ *
+ * Likewise register it with the names it uses directly so that
+ * expr_name_in_use need not scan every name.
  */
 static void
 expr_name_handle_references (GnmNamedExpr *nexpr, gboolean add)
 {
 	GSList *sheets, *ptr;
+	struct cb_name_references args;
 
 	sheets = gnm_expr_top_referenced_sheets (nexpr->texpr);
 
@@ -554,6 +583,10 @@ expr_name_handle_references (GnmNamedExpr *nexpr, gboolean add)
 		}
 	}
 	g_slist_free (sheets);
+
+	args.nexpr = nexpr;
+	args.add = add;
+	gnm_expr_walk (nexpr->texpr->expr, cb_name_references, &args);
 }
 
 
@@ -605,6 +638,7 @@ expr_name_new (char const *name)
 	nexpr->name		= go_string_new (name);
 	nexpr->texpr		= NULL;
 	nexpr->dependents	= NULL;
+	nexpr->referencing_names = NULL;
 	nexpr->is_placeholder	= TRUE;
 	nexpr->is_hidden	= FALSE;
 	nexpr->is_permanent	= FALSE;
@@ -825,6 +859,11 @@ expr_name_unref (GnmNamedExpr *nexpr)
 		nexpr->dependents  = NULL;
 	}
 
+	if (nexpr->referencing_names != NULL) {
+		g_hash_table_destroy (nexpr->referencing_names);
+		nexpr->referencing_names = NULL;
+	}
+
 	nexpr->pos.wb      = NULL;
 	nexpr->pos.sheet   = NULL;
 
@@ -1138,56 +1177,33 @@ expr_name_is_active (GnmNamedExpr const *nexpr)
 	return nexpr->scope != NULL;
 }
 
-struct cb_expr_name_in_use {
-	GnmNamedExpr *nexpr;
-	gboolean in_use;
-};
-
-static void
-cb_expr_name_in_use (G_GNUC_UNUSED gconstpointer key,
-		     GnmNamedExpr *nexpr,
-		     struct cb_expr_name_in_use *pdata)
-{
-	if (!pdata->in_use) {
-		struct cb_name_loop_check args;
-
-		args.name = NULL;
-		args.nexpr = pdata->nexpr;
-		args.stop_at_name = TRUE;
-		args.res = FALSE;
-		gnm_expr_walk (nexpr->texpr->expr, cb_name_loop_check, &args);
-		pdata->in_use = args.res;
-	}
-}
-
 /**
  * expr_name_in_use:
  * @nexpr: A named expression.
  *
- * Returns: TRUE, if the named expression appears to be in use.  This is an
- * approximation only, as we only look at the workbook in which the name is
- * defined.
+ * Returns: TRUE, if the named expression appears to be in use, i.e., if
+ * a dependent or an active name refers to it directly.
  */
 
 gboolean
 expr_name_in_use (GnmNamedExpr *nexpr)
 {
-	Workbook *wb;
-	struct cb_expr_name_in_use data;
+	GHashTableIter hiter;
+	gpointer key;
 
 	if (nexpr->dependents != NULL &&
 	    g_hash_table_size (nexpr->dependents) != 0)
 		return TRUE;
 
-	data.nexpr = nexpr;
-	data.in_use = FALSE;
+	if (nexpr->referencing_names == NULL)
+		return FALSE;
 
-	wb = nexpr->pos.sheet ? nexpr->pos.sheet->workbook : nexpr->pos.wb;
-	workbook_foreach_name (wb, FALSE,
-			       (GHFunc)cb_expr_name_in_use,
-			       &data);
+	g_hash_table_iter_init (&hiter, nexpr->referencing_names);
+	while (g_hash_table_iter_next (&hiter, &key, NULL))
+		if (expr_name_is_active (key))
+			return TRUE;
 
-	return data.in_use;
+	return FALSE;
 }
 
 
@@ -12,6 +12,7 @@ struct _GnmNamedExpr {
 	GOString   *name;
 	GnmParsePos    pos;
 	GHashTable *dependents;
+	GHashTable *referencing_names;	/* names whose expressions use this */
 	GnmExprTop const *texpr;
 	gboolean    is_placeholder;
 	gboolean    is_hidden;
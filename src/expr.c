@@ -915,50 +915,63 @@ value_intersection (GnmValue *v, GnmEvalPos const *pos)
 	return value_new_error_VALUE (pos);
 }
 
+/*
+ * Apply arithmetic operator @op to @va and @vb.  Returns NULL and stores
+ * the result in @res, or returns an error value.
+ */
 static GnmValue *
-bin_arith (GnmExpr const *expr, GnmEvalPos const *ep,
-	   GnmValue const *a, GnmValue const *b)
+bin_arith_float (GnmExprOp op, GnmEvalPos const *ep,
+		 gnm_float va, gnm_float vb, gnm_float *res)
 {
-	gnm_float const va = value_get_as_float (a);
-	gnm_float const vb = value_get_as_float (b);
-	gnm_float res;
-
-	switch (GNM_EXPR_GET_OPER (expr)) {
+	switch (op) {
 	case GNM_EXPR_OP_ADD:
-		res = va + vb;
+		*res = va + vb;
 		break;
 
 	case GNM_EXPR_OP_SUB:
-		res = va - vb;
+		*res = va - vb;
 		break;
 
 	case GNM_EXPR_OP_MULT:
-		res = va * vb;
+		*res = va * vb;
 		break;
 
 	case GNM_EXPR_OP_DIV:
 		if (vb == 0.0)
 			return value_new_error_DIV0 (ep);
-		res = va / vb;
+		*res = va / vb;
 		break;
 
 	case GNM_EXPR_OP_EXP:
 		if ((va == 0 && vb <= 0) || (va < 0 && vb != (int)vb))
 			return value_new_error_NUM (ep);
 
-		res = gnm_pow (va, vb);
+		*res = gnm_pow (va, vb);
 		break;
 
 	default:
 		g_assert_not_reached ();
 	}
 
-	if (gnm_finite (res))
-		return value_new_float (res);
+	if (gnm_finite (*res))
+		return NULL;
 	else
 		return value_new_error_NUM (ep);
 }
 
+static GnmValue *
+bin_arith (GnmExpr const *expr, GnmEvalPos const *ep,
+	   GnmValue const *a, GnmValue const *b)
+{
+	gnm_float res;
+	GnmValue *err = bin_arith_float (GNM_EXPR_GET_OPER (expr), ep,
+					 value_get_as_float (a),
+					 value_get_as_float (b),
+					 &res);
+
+	return err ? err : value_new_float (res);
+}
+
 static GnmValue *
 bin_cmp (GnmExprOp op, GnmValDiff comp, GnmEvalPos const *ep)
 {
@@ -2973,6 +2986,583 @@ gnm_expr_sharer_report (GnmExprSharer *es)
 
 /***************************************************************************/
 
+/*
+ * Expression programs.
+ *
+ * Scalar formulas such as =IF(A2>0,B2*C2/D2,0) are compiled into a short
+ * list of register instructions.  Plain floats and booleans live unboxed
+ * in registers; everything else is kept as a GnmValue.  Only cell
+ * references, scalar constants, arithmetic, comparisons and IF are
+ * compiled.  None of those can produce a range or an array in scalar
+ * context, so a program never has to give up half way and the results
+ * are exactly those of the tree evaluator.  Expressions with any other
+ * construct are left to the tree evaluator entirely.  Programs are only
+ * used for scalar, non-array evaluation.
+ */
+
+typedef enum {
+	PI_CONST,	/* dst := constant u.v, with flags arg */
+	PI_CELLREF,	/* dst := cell u.expr, with flags arg */
+	PI_BOOL,	/* dst := boolean arg */
+	PI_TONUM,	/* a := number, or dst := error and jump */
+	PI_JERR,	/* if a is an error, dst := a and jump */
+	PI_JFALSE,	/* consume a; jump unless true */
+	PI_JUMP,	/* jump */
+	PI_ARITH,	/* dst := a <arg> b */
+	PI_CMP,		/* dst := a <arg> b */
+	PI_NEG,		/* dst := -a */
+	PI_PERCENT,	/* dst := a / 100 */
+	PI_IFRES	/* dst := empty value if dst is empty */
+} ProgramOp;
+
+typedef struct {
+	guint8 op;
+	guint8 arg;
+	guint16 dst, a, b;
+	union {
+		GnmExpr const *expr;
+		GnmValue const *v;
+		int target;
+	} u;
+} ProgramInstr;
+
+struct _GnmExprProgram {
+	int len;
+	int nregs;
+	ProgramInstr *code;
+};
+
+/* Marks expressions that are not worth compiling.  */
+static GnmExprProgram program_none;
+
+/* Marks expressions without a relative extent.  */
+static GnmRange rel_extent_none;
+
+#define PROGRAM_MAX_REGS 256
+
+enum {
+	REG_FLOAT,	/* f; also the cleared state */
+	REG_BOOL,	/* f is 0 or 1 */
+	REG_EMPTY,	/* no value */
+	REG_VALUE	/* v is owned */
+};
+
+typedef struct {
+	guint8 kind;
+	gnm_float f;
+	GnmValue *v;
+} ProgramReg;
+
+typedef struct {
+	GArray *code;
+	int nregs;
+	GnmFunc *f_if;
+} ProgramCompiler;
+
+static int
+program_emit (ProgramCompiler *pc, ProgramOp op, int arg,
+	      int dst, int a, int b)
+{
+	ProgramInstr instr;
+
+	memset (&instr, 0, sizeof (instr));
+	instr.op = op;
+	instr.arg = arg;
+	instr.dst = dst;
+	instr.a = a;
+	instr.b = b;
+	g_array_append_val (pc->code, instr);
+	return pc->code->len - 1;
+}
+
+static void
+program_patch (ProgramCompiler *pc, int i)
+{
+	g_array_index (pc->code, ProgramInstr, i).u.target = pc->code->len;
+}
+
+static gboolean
+program_is_if (ProgramCompiler *pc, GnmExpr const *expr)
+{
+	return GNM_EXPR_GET_OPER (expr) == GNM_EXPR_OP_FUNCALL &&
+		expr->func.func == pc->f_if &&
+		expr->func.argc >= 2 && expr->func.argc <= 3;
+}
+
+/*
+ * Compile @expr, evaluated with @flags, into register @r using registers
+ * above @r as temporaries.  This mirrors gnm_expr_eval and gnumeric_if2.
+ */
+static gboolean
+program_compile (ProgramCompiler *pc, GnmExpr const *expr,
+		 GnmExprEvalFlags flags, int r)
+{
+	GnmExprOp op;
+	int i, j1, j2;
+
+	if (r + 2 > PROGRAM_MAX_REGS)
+		return FALSE;
+	pc->nregs = MAX (pc->nregs, r + 2);
+	flags &= ~GNM_EXPR_EVAL_WANT_REF;
+
+	while (GNM_EXPR_GET_OPER (expr) == GNM_EXPR_OP_PAREN)
+		expr = expr->unary.value;
+
+	op = GNM_EXPR_GET_OPER (expr);
+	switch (op) {
+	case GNM_EXPR_OP_EQUAL:
+	case GNM_EXPR_OP_NOT_EQUAL:
+	case GNM_EXPR_OP_GT:
+	case GNM_EXPR_OP_GTE:
+	case GNM_EXPR_OP_LT:
+	case GNM_EXPR_OP_LTE:
+		flags |= GNM_EXPR_EVAL_PERMIT_EMPTY;
+		if (!program_compile (pc, expr->binary.value_a, flags, r))
+			return FALSE;
+		j1 = program_emit (pc, PI_JERR, 0, r, r, 0);
+		if (!program_compile (pc, expr->binary.value_b, flags, r + 1))
+			return FALSE;
+		j2 = program_emit (pc, PI_JERR, 0, r, r + 1, 0);
+		program_emit (pc, PI_CMP, op, r, r, r + 1);
+		program_patch (pc, j1);
+		program_patch (pc, j2);
+		return TRUE;
+
+	case GNM_EXPR_OP_ADD:
+	case GNM_EXPR_OP_SUB:
+	case GNM_EXPR_OP_MULT:
+	case GNM_EXPR_OP_DIV:
+	case GNM_EXPR_OP_EXP:
+		flags &= ~GNM_EXPR_EVAL_PERMIT_EMPTY;
+		if (!program_compile (pc, expr->binary.value_a, flags, r))
+			return FALSE;
+		j1 = program_emit (pc, PI_TONUM, 0, r, r, 0);
+		if (!program_compile (pc, expr->binary.value_b, flags, r + 1))
+			return FALSE;
+		j2 = program_emit (pc, PI_TONUM, 0, r, r + 1, 0);
+		program_emit (pc, PI_ARITH, op, r, r, r + 1);
+		program_patch (pc, j1);
+		program_patch (pc, j2);
+		return TRUE;
+
+	case GNM_EXPR_OP_UNARY_PLUS:
+		flags &= ~GNM_EXPR_EVAL_PERMIT_EMPTY;
+		return program_compile (pc, expr->unary.value, flags, r);
+
+	case GNM_EXPR_OP_UNARY_NEG:
+	case GNM_EXPR_OP_PERCENTAGE:
+		flags &= ~GNM_EXPR_EVAL_PERMIT_EMPTY;
+		if (!program_compile (pc, expr->unary.value, flags, r))
+			return FALSE;
+		j1 = program_emit (pc, PI_TONUM, 0, r, r, 0);
+		program_emit (pc,
+			      op == GNM_EXPR_OP_UNARY_NEG ? PI_NEG : PI_PERCENT,
+			      0, r, r, 0);
+		program_patch (pc, j1);
+		return TRUE;
+
+	case GNM_EXPR_OP_CELLREF:
+		i = program_emit (pc, PI_CELLREF, flags, r, 0, 0);
+		g_array_index (pc->code, ProgramInstr, i).u.expr = expr;
+		return TRUE;
+
+	case GNM_EXPR_OP_CONSTANT:
+		if (VALUE_IS_CELLRANGE (expr->constant.value) ||
+		    VALUE_IS_ARRAY (expr->constant.value))
+			break;
+		i = program_emit (pc, PI_CONST, flags, r, 0, 0);
+		g_array_index (pc->code, ProgramInstr, i).u.v =
+			expr->constant.value;
+		return TRUE;
+
+	case GNM_EXPR_OP_FUNCALL: {
+		GnmExprConstPtr const *argv = expr->func.argv;
+
+		if (!program_is_if (pc, expr))
+			break;
+
+		/* Condition; see gnumeric_if2.  */
+		if (!program_compile (pc, argv[0], 0, r))
+			return FALSE;
+		j1 = program_emit (pc, PI_JERR, 0, r, r, 0);
+		j2 = program_emit (pc, PI_JFALSE, 0, 0, r, 0);
+
+		if (gnm_expr_is_empty (argv[1])) {
+			i = program_emit (pc, PI_CONST, 0, r, 0, 0);
+			g_array_index (pc->code, ProgramInstr, i).u.v = value_zero;
+		} else {
+			if (!program_compile (pc, argv[1], flags, r))
+				return FALSE;
+			program_emit (pc, PI_IFRES, 0, r, 0, 0);
+		}
+		i = program_emit (pc, PI_JUMP, 0, 0, 0, 0);
+		program_patch (pc, j2);
+
+		if (expr->func.argc < 3)
+			program_emit (pc, PI_BOOL, FALSE, r, 0, 0);
+		else if (gnm_expr_is_empty (argv[2])) {
+			j2 = program_emit (pc, PI_CONST, 0, r, 0, 0);
+			g_array_index (pc->code, ProgramInstr, j2).u.v = value_zero;
+		} else {
+			if (!program_compile (pc, argv[2], flags, r))
+				return FALSE;
+			program_emit (pc, PI_IFRES, 0, r, 0, 0);
+		}
+		program_patch (pc, i);
+		program_patch (pc, j1);
+		return TRUE;
+	}
+
+	default:
+		break;
+	}
+
+	/* Anything else could yield a range or have side effects.  */
+	return FALSE;
+}
+
+static GnmExprProgram *
+gnm_expr_program_new (GnmExpr const *expr)
+{
+	static GnmFunc *f_if = NULL;
+	ProgramCompiler pc;
+	GnmExprProgram *prog;
+	gboolean ok;
+
+	if (!f_if)
+		f_if = gnm_func_lookup ("if", NULL);
+
+	pc.f_if = f_if;
+	pc.nregs = 0;
+
+	while (GNM_EXPR_GET_OPER (expr) == GNM_EXPR_OP_PAREN)
+		expr = expr->unary.value;
+
+	/* Only compile when the top does real work of its own.  */
+	switch (GNM_EXPR_GET_OPER (expr)) {
+	case GNM_EXPR_OP_EQUAL:
+	case GNM_EXPR_OP_NOT_EQUAL:
+	case GNM_EXPR_OP_GT:
+	case GNM_EXPR_OP_GTE:
+	case GNM_EXPR_OP_LT:
+	case GNM_EXPR_OP_LTE:
+	case GNM_EXPR_OP_ADD:
+	case GNM_EXPR_OP_SUB:
+	case GNM_EXPR_OP_MULT:
+	case GNM_EXPR_OP_DIV:
+	case GNM_EXPR_OP_EXP:
+	case GNM_EXPR_OP_UNARY_NEG:
+	case GNM_EXPR_OP_PERCENTAGE:
+		break;
+	case GNM_EXPR_OP_FUNCALL:
+		if (program_is_if (&pc, expr))
+			break;
+		/* Fall through */
+	default:
+		return &program_none;
+	}
+
+	pc.code = g_array_new (FALSE, FALSE, sizeof (ProgramInstr));
+	ok = program_compile (&pc, expr, GNM_EXPR_EVAL_SCALAR_NON_EMPTY, 0);
+	if (!ok) {
+		g_array_free (pc.code, TRUE);
+		return &program_none;
+	}
+
+	prog = g_new (GnmExprProgram, 1);
+	prog->len = pc.code->len;
+	prog->nregs = pc.nregs;
+	prog->code = (ProgramInstr *)g_array_free (pc.code, FALSE);
+	return prog;
+}
+
+static void
+gnm_expr_program_free (GnmExprProgram *prog)
+{
+	if (prog == NULL || prog == &program_none)
+		return;
+	g_free (prog->code);
+	g_free (prog);
+}
+
+static inline void
+program_reg_clear (ProgramReg *reg)
+{
+	if (reg->kind == REG_VALUE)
+		value_release (reg->v);
+	reg->kind = REG_FLOAT;
+	reg->v = NULL;
+}
+
+static inline void
+program_reg_set_float (ProgramReg *reg, gnm_float f)
+{
+	program_reg_clear (reg);
+	reg->f = f;
+}
+
+/* Takes ownership of @v, unboxing plain floats and booleans.  */
+static void
+program_reg_set_value (ProgramReg *reg, GnmValue *v)
+{
+	program_reg_clear (reg);
+	if (v == NULL)
+		reg->kind = REG_EMPTY;
+	else if (VALUE_FMT (v) != NULL ||
+		 !(VALUE_IS_FLOAT (v) || VALUE_IS_BOOLEAN (v))) {
+		reg->kind = REG_VALUE;
+		reg->v = v;
+	} else {
+		reg->kind = VALUE_IS_FLOAT (v) ? REG_FLOAT : REG_BOOL;
+		reg->f = VALUE_IS_FLOAT (v)
+			? v->v_float.val
+			: (v->v_bool.val ? 1 : 0);
+		value_release (v);
+	}
+}
+
+static void
+program_reg_move (ProgramReg *dst, ProgramReg *src)
+{
+	if (dst == src)
+		return;
+	program_reg_clear (dst);
+	*dst = *src;
+	src->kind = REG_FLOAT;
+	src->v = NULL;
+}
+
+/* Returns the register's value, leaving the register cleared.  */
+static GnmValue *
+program_reg_take (ProgramReg *reg)
+{
+	GnmValue *v;
+
+	switch (reg->kind) {
+	case REG_FLOAT: v = value_new_float (reg->f); break;
+	case REG_BOOL: v = value_new_bool (reg->f != 0); break;
+	case REG_EMPTY: v = NULL; break;
+	default: v = reg->v; break;
+	}
+	reg->kind = REG_FLOAT;
+	reg->v = NULL;
+	return v;
+}
+
+static inline gnm_float
+program_reg_float (ProgramReg const *reg)
+{
+	return reg->kind == REG_VALUE ? value_get_as_float (reg->v) : reg->f;
+}
+
+/*
+ * Convert register @a to a number for arithmetic.  On failure the error
+ * goes into @dst and FALSE is returned.
+ */
+static gboolean
+program_reg_to_number (ProgramReg *a, ProgramReg *dst, GnmEvalPos const *pos)
+{
+	GnmValue *v;
+
+	switch (a->kind) {
+	case REG_FLOAT:
+		return TRUE;
+	case REG_BOOL:
+		a->kind = REG_FLOAT;
+		return TRUE;
+	case REG_EMPTY:
+		program_reg_set_value (dst, value_new_error_VALUE (pos));
+		return FALSE;
+	default:
+		break;
+	}
+
+	v = a->v;
+	if (VALUE_IS_ERROR (v)) {
+		program_reg_move (dst, a);
+		return FALSE;
+	} else if (VALUE_IS_STRING (v)) {
+		GnmValue *tmp = format_match_number (value_peek_string (v), NULL,
+			sheet_date_conv (pos->sheet));
+		program_reg_clear (a);
+		if (tmp == NULL) {
+			program_reg_set_value (dst, value_new_error_VALUE (pos));
+			return FALSE;
+		}
+		program_reg_set_value (a, tmp);
+	} else if (!VALUE_IS_NUMBER (v)) {
+		program_reg_clear (a);
+		program_reg_set_value (dst, value_new_error_VALUE (pos));
+		return FALSE;
+	}
+	if (a->kind == REG_BOOL)
+		a->kind = REG_FLOAT;
+	return TRUE;
+}
+
+static void
+program_load (ProgramReg *dst, GnmValue const *v, GnmExprEvalFlags flags)
+{
+	if (v == NULL || VALUE_IS_EMPTY (v)) {
+		/* See handle_empty.  */
+		if (flags & GNM_EXPR_EVAL_PERMIT_EMPTY) {
+			program_reg_clear (dst);
+			dst->kind = REG_EMPTY;
+		} else
+			program_reg_set_float (dst, 0);
+	} else if (VALUE_IS_FLOAT (v) && VALUE_FMT (v) == NULL)
+		program_reg_set_float (dst, v->v_float.val);
+	else
+		program_reg_set_value (dst, value_dup (v));
+}
+
+/* Run @prog and return its result.  */
+static GnmValue *
+gnm_expr_program_run (GnmExprProgram const *prog, GnmEvalPos const *pos)
+{
+	ProgramReg *regs = g_alloca (prog->nregs * sizeof (ProgramReg));
+	GnmValue *res;
+	int pc = 0, i;
+
+	for (i = 0; i < prog->nregs; i++) {
+		regs[i].kind = REG_FLOAT;
+		regs[i].v = NULL;
+	}
+
+	while (pc < prog->len) {
+		ProgramInstr const *instr = prog->code + pc++;
+		ProgramReg *dst = regs + instr->dst;
+		ProgramReg *a = regs + instr->a;
+		ProgramReg *b = regs + instr->b;
+
+		switch ((ProgramOp)instr->op) {
+		case PI_CONST:
+			program_load (dst, instr->u.v, instr->arg);
+			break;
+
+		case PI_CELLREF: {
+			GnmCellRef r;
+			GnmCell *cell;
+
+			gnm_cellref_make_abs (&r, &instr->u.expr->cellref.ref, pos);
+			cell = sheet_cell_get (eval_sheet (r.sheet, pos->sheet),
+					       r.col, r.row);
+			if (cell)
+				gnm_cell_eval (cell);
+			program_load (dst, cell ? cell->value : NULL, instr->arg);
+			break;
+		}
+
+		case PI_BOOL:
+			program_reg_set_float (dst, instr->arg ? 1 : 0);
+			dst->kind = REG_BOOL;
+			break;
+
+		case PI_TONUM:
+			if (!program_reg_to_number (a, dst, pos))
+				pc = instr->u.target;
+			break;
+
+		case PI_JERR:
+			if (a->kind == REG_VALUE && VALUE_IS_ERROR (a->v)) {
+				program_reg_move (dst, a);
+				pc = instr->u.target;
+			}
+			break;
+
+		case PI_JFALSE: {
+			gboolean c;
+
+			switch (a->kind) {
+			case REG_FLOAT:
+			case REG_BOOL: c = (a->f != 0); break;
+			case REG_EMPTY: c = FALSE; break;
+			default: c = value_get_as_bool (a->v, NULL); break;
+			}
+			program_reg_clear (a);
+			if (!c)
+				pc = instr->u.target;
+			break;
+		}
+
+		case PI_JUMP:
+			pc = instr->u.target;
+			break;
+
+		case PI_ARITH: {
+			gnm_float x;
+			GnmValue *err = bin_arith_float (instr->arg, pos,
+							 program_reg_float (a),
+							 program_reg_float (b),
+							 &x);
+			program_reg_clear (b);
+			if (err)
+				program_reg_set_value (dst, err);
+			else
+				program_reg_set_float (dst, x);
+			break;
+		}
+
+		case PI_CMP:
+			if (a->kind == REG_FLOAT && b->kind == REG_FLOAT) {
+				gnm_float x = a->f, y = b->f;
+				gboolean c;
+
+				switch (instr->arg) {
+				case GNM_EXPR_OP_EQUAL: c = (x == y); break;
+				case GNM_EXPR_OP_GT: c = (x > y); break;
+				case GNM_EXPR_OP_LT: c = (x < y); break;
+				case GNM_EXPR_OP_NOT_EQUAL: c = (x != y); break;
+				case GNM_EXPR_OP_LTE: c = (x <= y); break;
+				default:
+				case GNM_EXPR_OP_GTE: c = (x >= y); break;
+				}
+				program_reg_set_float (dst, c ? 1 : 0);
+				dst->kind = REG_BOOL;
+			} else {
+				GnmValue *va = program_reg_take (a);
+				GnmValue *vb = program_reg_take (b);
+				GnmValue *v = bin_cmp (instr->arg,
+						       value_compare (va, vb, FALSE),
+						       pos);
+				value_release (va);
+				value_release (vb);
+				program_reg_set_value (dst, v);
+			}
+			program_reg_clear (b);
+			break;
+
+		case PI_NEG:
+			if (a->kind == REG_FLOAT)
+				program_reg_set_float (dst, 0 - a->f);
+			else {
+				GnmValue *v = negate_value (a->v);
+				program_reg_set_value (dst, v);
+			}
+			break;
+
+		case PI_PERCENT: {
+			GnmValue *v = value_new_float (program_reg_float (a) / 100);
+			value_set_fmt (v, go_format_default_percentage ());
+			program_reg_set_value (dst, v);
+			break;
+		}
+
+		case PI_IFRES:
+			if (dst->kind == REG_EMPTY)
+				program_reg_set_value (dst, value_new_empty ());
+			break;
+		}
+	}
+
+	res = program_reg_take (regs);
+	for (i = 0; i < prog->nregs; i++)
+		program_reg_clear (regs + i);
+	return res;
+}
+
+/***************************************************************************/
+
 GnmExprTop const *
 gnm_expr_top_new (GnmExpr const *expr)
 {
@@ -2986,6 +3576,8 @@ gnm_expr_top_new (GnmExpr const *expr)
 	res->hash = 0;
 	res->refcount = 1;
 	res->expr = expr;
+	res->program = NULL;
+	res->rel_extent = NULL;
 	return res;
 }
 
@@ -3010,6 +3602,9 @@ gnm_expr_top_unref (GnmExprTop const *texpr)
 
 	((GnmExprTop *)texpr)->refcount--;
 	if (texpr->refcount == 0) {
+		gnm_expr_program_free (texpr->program);
+		if (texpr->rel_extent != &rel_extent_none)
+			g_free (texpr->rel_extent);
 		gnm_expr_free (texpr->expr);
 		((GnmExprTop *)texpr)->magic = 0;
 		g_free ((GnmExprTop *)texpr);
@@ -3208,6 +3803,149 @@ gnm_expr_top_relocate (GnmExprTop const *texpr,
 	return gnm_expr_top_new (gnm_expr_relocate (texpr->expr, &rinfo_tmp));
 }
 
+/*
+ * The relative extent of an expression is the bounding box of the offsets
+ * of everything it references, provided every reference is a relative
+ * reference to the expression's own sheet.  rel_extent_none marks
+ * expressions with any other kind of reference.
+ */
+
+static void
+rel_extent_add (GnmRange *ext, gboolean *first, GnmCellRef const *ref)
+{
+	if (*first) {
+		ext->start.col = ext->end.col = ref->col;
+		ext->start.row = ext->end.row = ref->row;
+		*first = FALSE;
+	} else {
+		ext->start.col = MIN (ext->start.col, ref->col);
+		ext->end.col = MAX (ext->end.col, ref->col);
+		ext->start.row = MIN (ext->start.row, ref->row);
+		ext->end.row = MAX (ext->end.row, ref->row);
+	}
+}
+
+typedef struct {
+	GnmRange ext;
+	gboolean first;
+	gboolean ok;
+} RelExtentClosure;
+
+static GnmExpr const *
+cb_rel_extent (GnmExpr const *expr, GnmExprWalk *data)
+{
+	RelExtentClosure *cl = data->user;
+	GnmCellRef const *a = NULL, *b = NULL;
+
+	switch (GNM_EXPR_GET_OPER (expr)) {
+	case GNM_EXPR_OP_CELLREF:
+		a = &expr->cellref.ref;
+		break;
+	case GNM_EXPR_OP_CONSTANT:
+		if (VALUE_IS_CELLRANGE (expr->constant.value)) {
+			a = &expr->constant.value->v_range.cell.a;
+			b = &expr->constant.value->v_range.cell.b;
+		}
+		break;
+	case GNM_EXPR_OP_NAME:
+	case GNM_EXPR_OP_ARRAY_CORNER:
+	case GNM_EXPR_OP_ARRAY_ELEM:
+		cl->ok = FALSE;
+		break;
+	default:
+		break;
+	}
+
+	if (a && (a->sheet || !a->col_relative || !a->row_relative))
+		cl->ok = FALSE;
+	else if (a)
+		rel_extent_add (&cl->ext, &cl->first, a);
+	if (b && (b->sheet || !b->col_relative || !b->row_relative))
+		cl->ok = FALSE;
+	else if (b)
+		rel_extent_add (&cl->ext, &cl->first, b);
+
+	if (!cl->ok)
+		data->stop = TRUE;
+	return NULL;
+}
+
+static GnmRange const *
+gnm_expr_top_get_rel_extent (GnmExprTop const *texpr)
+{
+	if (texpr->rel_extent == NULL) {
+		RelExtentClosure cl;
+
+		cl.first = TRUE;
+		cl.ok = TRUE;
+		memset (&cl.ext, 0, sizeof (cl.ext));
+		gnm_expr_walk (texpr->expr, cb_rel_extent, &cl);
+		((GnmExprTop *)texpr)->rel_extent = cl.ok
+			? g_memdup (&cl.ext, sizeof (cl.ext))
+			: &rel_extent_none;
+	}
+	return texpr->rel_extent;
+}
+
+/**
+ * gnm_expr_top_relocate_is_shift:
+ * @texpr: #GnmExprTop
+ * @rinfo: #GnmExprRelocateInfo with the position of @texpr
+ *
+ * Returns: %TRUE if @texpr, at @rinfo's position, moves together with
+ * everything it references.  Relocating it is then known to leave it
+ * unchanged, so gnm_expr_top_relocate need not be called.  A relocation
+ * with no offset, as used when pasting, only needs the references to stay
+ * on the sheet.  %FALSE means we do not know.
+ */
+gboolean
+gnm_expr_top_relocate_is_shift (GnmExprTop const *texpr,
+				GnmExprRelocateInfo const *rinfo)
+{
+	GnmRange const *ext;
+	GnmRange t;
+	GnmSheetSize const *ss;
+
+	g_return_val_if_fail (GNM_IS_EXPR_TOP (texpr), FALSE);
+	g_return_val_if_fail (rinfo != NULL, FALSE);
+
+	if (rinfo->reloc_type == GNM_EXPR_RELOCATE_INVALIDATE_SHEET ||
+	    rinfo->origin_sheet != rinfo->target_sheet ||
+	    rinfo->pos.sheet != rinfo->origin_sheet ||
+	    !range_contains (&rinfo->origin,
+			     rinfo->pos.eval.col, rinfo->pos.eval.row))
+		return FALSE;
+
+	ext = gnm_expr_top_get_rel_extent (texpr);
+	if (ext == &rel_extent_none)
+		return FALSE;
+
+	ss = gnm_sheet_get_size (rinfo->origin_sheet);
+	t.start.col = rinfo->pos.eval.col + ext->start.col;
+	t.end.col = rinfo->pos.eval.col + ext->end.col;
+	t.start.row = rinfo->pos.eval.row + ext->start.row;
+	t.end.row = rinfo->pos.eval.row + ext->end.row;
+
+	/* Everything referenced must move too, without wrapping around or
+	 * falling off the sheet.  */
+	if (rinfo->col_offset == 0 && rinfo->row_offset == 0)
+		return t.start.col >= 0 && t.end.col < ss->max_cols &&
+			t.start.row >= 0 && t.end.row < ss->max_rows;
+
+	/* Ranges reaching the last row or column stay pinned there, see
+	 * reloc_cellrange.  */
+	if ((rinfo->reloc_type == GNM_EXPR_RELOCATE_MOVE_RANGE ||
+	     rinfo->sticky_end) &&
+	    (t.end.col >= ss->max_cols - 1 || t.end.row >= ss->max_rows - 1))
+		return FALSE;
+
+	return range_contained (&t, &rinfo->origin) &&
+		t.start.col + rinfo->col_offset >= 0 &&
+		t.end.col + rinfo->col_offset < ss->max_cols &&
+		t.start.row + rinfo->row_offset >= 0 &&
+		t.end.row + rinfo->row_offset < ss->max_rows;
+}
+
 /*
  * Convenience function to change an expression from one sheet to another.
  */
@@ -3355,6 +4093,33 @@ gnm_expr_top_eval_array_elem (GnmExprTop const *texpr,
 	return handle_empty ((a != NULL) ? value_dup (a) : NULL, flags);
 }
 
+/*
+ * Evaluate @texpr through its compiled program, compiling it on first use.
+ * Returns FALSE if @texpr has no program.  GNM_DEBUG=no-expr-program
+ * disables programs entirely.
+ */
+static gboolean
+gnm_expr_top_eval_program (GnmExprTop const *texpr,
+			   GnmEvalPos const *pos,
+			   GnmValue **res)
+{
+	static int disabled = -1;
+
+	if (disabled < 0)
+		disabled = gnm_debug_flag ("no-expr-program");
+	if (disabled)
+		return FALSE;
+
+	if (texpr->program == NULL)
+		((GnmExprTop *)texpr)->program =
+			gnm_expr_program_new (texpr->expr);
+	if (texpr->program == &program_none)
+		return FALSE;
+
+	*res = gnm_expr_program_run (texpr->program, pos);
+	return TRUE;
+}
+
 GnmValue *
 gnm_expr_top_eval (GnmExprTop const *texpr,
 		   GnmEvalPos const *pos,
@@ -3370,7 +4135,9 @@ gnm_expr_top_eval (GnmExprTop const *texpr,
 		res = gnm_expr_top_eval_array_corner (texpr, pos, flags);
 	else if (gnm_expr_top_is_array_elem (texpr, NULL, NULL))
 		res = gnm_expr_top_eval_array_elem (texpr, pos, flags);
-	else
+	else if (!(flags == GNM_EXPR_EVAL_SCALAR_NON_EMPTY &&
+		   !eval_pos_is_array_context (pos) &&
+		   gnm_expr_top_eval_program (texpr, pos, &res)))
 		res = gnm_expr_eval (texpr->expr, pos, flags);
 	gnm_app_recalc_finish ();
 
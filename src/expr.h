@@ -139,11 +139,15 @@ GnmExprList *gnm_expr_list_copy	  (GnmExprList *list);
 #define GNM_EXPR_TOP_MAGIC 0x42
 #define GNM_IS_EXPR_TOP(et) ((et) && (et)->magic == GNM_EXPR_TOP_MAGIC)
 
+typedef struct _GnmExprProgram GnmExprProgram;
+
 struct _GnmExprTop {
 	unsigned magic : 8;
 	unsigned hash : 24;  /* Zero meaning not yet computed.  */
 	guint32 refcount;
 	GnmExpr const *expr;
+	GnmExprProgram *program;  /* NULL meaning not yet compiled.  */
+	GnmRange *rel_extent;	  /* NULL meaning not yet computed.  */
 };
 
 GnmExprTop const *gnm_expr_top_new		(GnmExpr const *e);
@@ -200,6 +204,8 @@ struct _GnmExprRelocateInfo {
 	gboolean sticky_end;
 
 };
+gboolean gnm_expr_top_relocate_is_shift (GnmExprTop const *texpr,
+					  GnmExprRelocateInfo const *rinfo);
 GnmExprTop const *gnm_expr_top_relocate	 (GnmExprTop const *texpr,
 					  GnmExprRelocateInfo const *rinfo,
 					  gboolean include_rel);
@@ -32,11 +32,13 @@
 #include <gui-util.h>
 #include <expr-deriv.h>
 #include <gnm-marshalers.h>
+#include <application.h>
 
 #include <goffice/goffice.h>
 #include <glib.h>
 #include <string.h>
 #include <stdlib.h>
+#include <math.h>
 
 enum {
 	PROP_0,
@@ -49,6 +51,7 @@ enum {
 	SIG_LOAD_STUB,
 	SIG_LINK_DEP,
 	SIG_DERIVATIVE,
+	SIG_EVAL_VECTOR,
 	LAST_SIGNAL
 };
 static guint signals[LAST_SIGNAL] = { 0 };
@@ -62,6 +65,8 @@ static GHashTable *functions_by_localized_name;
 
 static GnmFunc    *fn_if;
 
+static void func_memo_shutdown (void);
+
 /**
  * gnm_func_init_: (skip)
  */
@@ -87,6 +92,7 @@ void
 gnm_func_shutdown_ (void)
 {
 	fn_if = NULL;
+	func_memo_shutdown ();
 
 	while (unknown_cat != NULL && unknown_cat->functions != NULL) {
 		GnmFunc *func = unknown_cat->functions->data;
@@ -327,6 +333,8 @@ gnm_func_is_fixargs (GnmFunc *func)
 void
 gnm_func_set_stub (GnmFunc *func)
 {
+	gnm_func_memo_clear ();
+
 	func->fn_type = GNM_FUNC_TYPE_STUB;
 
 	g_free (func->arg_spec);
@@ -679,6 +687,7 @@ gnm_func_set_flags (GnmFunc *func, GnmFuncFlags f)
 {
 	g_return_if_fail (GNM_IS_FUNC (func));
 	func->flags = f;
+	gnm_func_memo_clear ();
 }
 
 GnmFuncImplStatus
@@ -1234,6 +1243,262 @@ free_values (GnmValue **values, int top)
 
 /* ------------------------------------------------------------------------- */
 
+/*
+ * Result memo for functions flagged GNM_FUNC_PURE.  Results are keyed on the
+ * function and its scalar argument values.  The memo is bounded; when full
+ * it is emptied.  It is also emptied whenever a function definition
+ * changes.
+ */
+
+#define FUNC_MEMO_MAX_ENTRIES 16384
+#define FUNC_MEMO_MAX_ARGS 8
+
+typedef struct {
+	gnm_float x;
+	int type;		/* 0: missing; 1: number; 2: boolean */
+} FuncMemoArg;
+
+typedef struct {
+	GnmFunc const *func;
+	guint hash;
+	int argc, n;
+	FuncMemoArg args[FUNC_MEMO_MAX_ARGS];	/* Only n are allocated */
+} FuncMemoKey;
+
+static GHashTable *func_memo;
+static gulong func_memo_handler;
+static guint func_memo_hits, func_memo_misses, func_memo_flushes;
+static guint func_memo_reported;
+
+static guint
+func_memo_hash (FuncMemoKey const *key)
+{
+	return key->hash;
+}
+
+static gboolean
+func_memo_equal (FuncMemoKey const *a, FuncMemoKey const *b)
+{
+	int i;
+
+	if (a->hash != b->hash || a->func != b->func ||
+	    a->argc != b->argc || a->n != b->n)
+		return FALSE;
+
+	for (i = 0; i < a->n; i++) {
+		FuncMemoArg const *aa = a->args + i, *bb = b->args + i;
+		if (aa->type != bb->type || aa->x != bb->x ||
+		    !signbit (aa->x) != !signbit (bb->x))
+			return FALSE;
+	}
+	return TRUE;
+}
+
+static void
+cb_func_memo_report (void)
+{
+	if (func_memo_reported == func_memo_hits + func_memo_misses)
+		return;
+	func_memo_reported = func_memo_hits + func_memo_misses;
+	g_printerr ("Function memo: %u hits, %u misses, %u entries, %u flushes\n",
+		    func_memo_hits, func_memo_misses,
+		    func_memo ? g_hash_table_size (func_memo) : 0,
+		    func_memo_flushes);
+}
+
+/**
+ * gnm_func_memo_clear:
+ *
+ * Empties the result memo of pure functions.
+ */
+void
+gnm_func_memo_clear (void)
+{
+	if (func_memo)
+		g_hash_table_remove_all (func_memo);
+}
+
+/**
+ * gnm_func_memo_get_stats:
+ * @hits: (out) (optional): number of calls answered from the memo
+ * @misses: (out) (optional): number of memoizable calls computed
+ * @entries: (out) (optional): current number of memo entries
+ */
+void
+gnm_func_memo_get_stats (guint *hits, guint *misses, guint *entries)
+{
+	if (hits)
+		*hits = func_memo_hits;
+	if (misses)
+		*misses = func_memo_misses;
+	if (entries)
+		*entries = func_memo ? g_hash_table_size (func_memo) : 0;
+}
+
+static void
+func_memo_shutdown (void)
+{
+	if (func_memo_handler) {
+		g_signal_handler_disconnect (gnm_app_get_app (),
+					     func_memo_handler);
+		func_memo_handler = 0;
+	}
+	if (func_memo) {
+		g_hash_table_destroy (func_memo);
+		func_memo = NULL;
+	}
+}
+
+/*
+ * Call @fn_def with marshalled @args, answering from the memo when all
+ * arguments are plain numbers or booleans.
+ */
+static GnmValue *
+func_memo_call (GnmFuncEvalInfo *ei, GnmFunc const *fn_def,
+		GnmValue **args)
+{
+	int i, n = fn_def->max_args;
+	FuncMemoKey key, *new_key;
+	GnmValue *res;
+
+	if (n > FUNC_MEMO_MAX_ARGS)
+		goto uncached;
+
+	key.func = fn_def;
+	key.argc = ei->func_call->argc;
+	key.n = n;
+	key.hash = g_direct_hash (fn_def) ^ key.argc;
+	for (i = 0; i < n; i++) {
+		GnmValue const *v = args[i];
+		double d;
+
+		if (v == NULL) {
+			key.args[i].type = 0;
+			key.args[i].x = 0;
+		} else if (VALUE_FMT (v) != NULL)
+			goto uncached;
+		else if (VALUE_IS_FLOAT (v)) {
+			key.args[i].type = 1;
+			key.args[i].x = value_get_as_float (v);
+		} else if (VALUE_IS_BOOLEAN (v)) {
+			key.args[i].type = 2;
+			key.args[i].x = v->v_bool.val ? 1 : 0;
+		} else
+			goto uncached;
+
+		d = key.args[i].x;
+		key.hash = key.hash * 31 + key.args[i].type;
+		key.hash = key.hash * 31 + g_double_hash (&d);
+	}
+
+	if (func_memo) {
+		res = g_hash_table_lookup (func_memo, &key);
+		if (res) {
+			func_memo_hits++;
+			return value_dup (res);
+		}
+	} else {
+		func_memo = g_hash_table_new_full
+			((GHashFunc)func_memo_hash,
+			 (GEqualFunc)func_memo_equal,
+			 g_free,
+			 (GDestroyNotify)value_release);
+		if (gnm_debug_flag ("func-memo"))
+			func_memo_handler = g_signal_connect
+				(gnm_app_get_app (), "recalc-finished",
+				 G_CALLBACK (cb_func_memo_report), NULL);
+	}
+
+	func_memo_misses++;
+	res = fn_def->args_func (ei, (GnmValue const * const *)args);
+	if (res == NULL)
+		return NULL;
+
+	if (g_hash_table_size (func_memo) >= FUNC_MEMO_MAX_ENTRIES) {
+		g_hash_table_remove_all (func_memo);
+		func_memo_flushes++;
+	}
+	new_key = g_malloc (G_STRUCT_OFFSET (FuncMemoKey, args) +
+			    n * sizeof (FuncMemoArg));
+	memcpy (new_key, &key,
+		G_STRUCT_OFFSET (FuncMemoKey, args) + n * sizeof (FuncMemoArg));
+	g_hash_table_insert (func_memo, new_key, value_dup (res));
+	return res;
+
+ uncached:
+	return fn_def->args_func (ei, (GnmValue const * const *)args);
+}
+
+/* ------------------------------------------------------------------------- */
+
+/*
+ * Implicit iteration of a one-argument numeric function over @arg, handing
+ * all the numbers to the function's "eval-vector" handler at once.  Elements
+ * are marshalled exactly as for per-element calls.  Returns %NULL when the
+ * function has no handler or the handler declines.
+ */
+static GnmValue *
+function_call_vector (GnmFuncEvalInfo *ei, GnmFunc const *fn_def,
+		      GnmValue const *arg, int w, int h)
+{
+	GnmValue *res;
+	gnm_float *xs;
+	int x, y, n = 0;
+	gboolean handled = FALSE;
+
+	if (fn_def->arg_types[0] != 'f' ||
+	    !g_signal_has_handler_pending ((gpointer)fn_def,
+					   signals[SIG_EVAL_VECTOR], 0, FALSE))
+		return NULL;
+
+	res = value_new_array_empty (w, h);
+	xs = g_new (gnm_float, w * h);
+	for (x = 0; x < w; x++)
+		for (y = 0; y < h; y++) {
+			GnmValue const *elem =
+				value_area_get_x_y (arg, x, y, ei->pos);
+			GnmValue *v = NULL;
+
+			if (VALUE_IS_EMPTY (elem))
+				xs[n++] = 0;
+			else if (VALUE_IS_STRING (elem)) {
+				v = format_match_number
+					(value_peek_string (elem), NULL,
+					 sheet_date_conv (ei->pos->sheet));
+				if (v == NULL)
+					v = value_new_error_VALUE (ei->pos);
+				else {
+					xs[n++] = value_get_as_float (v);
+					value_release (v);
+					v = NULL;
+				}
+			} else if (VALUE_IS_ERROR (elem))
+				v = value_dup (elem);
+			else if (VALUE_IS_NUMBER (elem))
+				xs[n++] = value_get_as_float (elem);
+			else
+				v = value_new_error_VALUE (ei->pos);
+			res->v_array.vals[x][y] = v;
+		}
+
+	g_signal_emit ((gpointer)fn_def, signals[SIG_EVAL_VECTOR], 0,
+		       ei, xs, n, &handled);
+	if (!handled) {
+		g_free (xs);
+		value_release (res);
+		return NULL;
+	}
+
+	n = 0;
+	for (x = 0; x < w; x++)
+		for (y = 0; y < h; y++)
+			if (res->v_array.vals[x][y] == NULL)
+				res->v_array.vals[x][y] =
+					value_new_float (xs[n++]);
+	g_free (xs);
+	return res;
+}
+
 /**
  * function_call_with_exprs:
  * @ei: EvalInfo containing valid fn_def!
@@ -1424,7 +1689,11 @@ function_call_with_exprs (GnmFuncEvalInfo *ei)
 	while (i < fn_def->max_args)
 		args [i++] = NULL;
 
-	if (iter_item != NULL) {
+	if (iter_item != NULL && iter_count == 1 && fn_def->max_args == 1 &&
+	    (tmp = function_call_vector (ei, fn_def, args[0],
+					 iter_width, iter_height)) != NULL) {
+		i = fn_def->max_args;
+	} else if (iter_item != NULL) {
 		int x, y;
 		GnmValue *res = value_new_array_empty (iter_width, iter_height);
 		GnmValue const *elem, *err;
@@ -1486,7 +1755,9 @@ function_call_with_exprs (GnmFuncEvalInfo *ei)
 			args[iter_item[i]] = iter_vals[i];
 		tmp = res;
 		i = fn_def->max_args;
-	} else
+	} else if (fn_def->flags & GNM_FUNC_PURE)
+		tmp = func_memo_call (ei, fn_def, args);
+	else
 		tmp = fn_def->args_func (ei, (GnmValue const * const *)args);
 
 	free_values (args, i);
@@ -1822,6 +2093,7 @@ typedef struct {
 	void (*load_stub) (GnmFunc *func);
 	int (*link_dep) (GnmFunc *func, GnmFuncEvalInfo *ei, gboolean qlink);
 	GnmExpr* (*derivative) (GnmFunc *func, GnmExpr const *expr, GnmEvalPos *ep, GnmExprDeriv *info);
+	gboolean (*eval_vector) (GnmFunc *func, GnmFuncEvalInfo *ei, gnm_float *xs, int n);
 } GnmFuncClass;
 
 static void
@@ -1829,6 +2101,8 @@ gnm_func_finalize (GObject *obj)
 {
 	GnmFunc *func = GNM_FUNC (obj);
 
+	gnm_func_memo_clear ();
+
 	g_free (func->arg_types);
 
 	g_free ((char *)func->name);
@@ -2016,6 +2290,30 @@ gnm_func_class_init (GObjectClass *gobject_class)
 		 gnm__BOXED__BOXED_BOXED_BOXED,
 		 gnm_expr_get_type(),
 		 3, gnm_expr_get_type(), gnm_eval_pos_get_type(), gnm_expr_deriv_info_get_type());
+
+	/**
+	 * GnmFunc::eval-vector:
+	 * @func: #GnmFunc
+	 * @ei: #GnmFuncEvalInfo for the call being iterated
+	 * @xs: (array length=n): the numeric arguments
+	 * @n: number of elements in @xs
+	 *
+	 * Signals that a one-argument numeric function is being applied
+	 * element-wise to an array.  A handler may replace every element of
+	 * @xs by the function's value there, using a non-finite value for
+	 * #NUM!, and return %TRUE.  Returning %FALSE makes the caller fall
+	 * back to calling the function once per element.
+	 *
+	 * Returns: %TRUE if @xs has been evaluated.
+	 */
+	signals[SIG_EVAL_VECTOR] = g_signal_new
+		("eval-vector",
+		 GNM_FUNC_TYPE,
+		 G_SIGNAL_RUN_LAST,
+		 G_STRUCT_OFFSET (GnmFuncClass, eval_vector),
+		 g_signal_accumulator_true_handled, NULL,
+		 gnm__BOOLEAN__POINTER_POINTER_INT,
+		 G_TYPE_BOOLEAN, 3, G_TYPE_POINTER, G_TYPE_POINTER, G_TYPE_INT);
 }
 
 GSF_CLASS (GnmFunc, gnm_func,
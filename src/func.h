@@ -75,6 +75,9 @@ typedef enum {
 	GNM_FUNC_VOLATILE		= 1 << 0, /* eg now(), today() */
 	GNM_FUNC_RETURNS_NON_SCALAR	= 1 << 1, /* eg transpose(), mmult() */
 
+	/* result depends only on scalar argument values; may be memoized */
+	GNM_FUNC_PURE			= 1 << 2,
+
 	/* an unknown function that will hopefully be defined later */
 	GNM_FUNC_IS_PLACEHOLDER		= 1 << 3,
 	GNM_FUNC_IS_WORKBOOK_LOCAL	= 1 << 5,
@@ -278,6 +281,9 @@ char       *gnm_func_convert_markup_to_pango (char const *desc,
 /*************************************************************************/
 
 GnmValue *function_call_with_exprs	(GnmFuncEvalInfo *ei);
+void      gnm_func_memo_clear		(void);
+void      gnm_func_memo_get_stats	(guint *hits, guint *misses,
+					 guint *entries);
 GnmValue *function_call_with_values     (GnmEvalPos const *ep, char const *name,
 					 int argc, GnmValue const * const *values);
 GnmValue *function_def_call_with_values (GnmEvalPos const *ep, GnmFunc const *fn,
@@ -25,10 +25,12 @@
 #include <gnm-format.h>
 #include <value.h>
 #include <cell.h>
+#include <numbers.h>
 
 #include <goffice/goffice.h>
 #include <glib/gi18n-lib.h>
 #include <string.h>
+#include <math.h>
 #include <style-font.h>
 
 #define UTF8_NEWLINE "\xe2\x86\xa9" /* unicode U+21A9 */
@@ -85,6 +87,157 @@ hash_fill (PangoLayout *layout, GString *str, const GOFontMetrics *metrics, int
 	}
 }
 
+/* ------------------------------------------------------------------------- */
+/*
+ * Fast paths for a handful of very common formats, used when rendering to
+ * a string without width limit as done by the exporters.  These only
+ * kick in when the result does not depend on rounding, i.e., for values
+ * that are integers after scaling, so they cannot differ from what the
+ * generic goffice interpreter produces.  Anything else falls through.
+ */
+
+typedef enum {
+	FAST_FORMAT_NONE,
+	FAST_FORMAT_NUMBER,	/* General, 0, 0.00, #,##0.00, ... */
+	FAST_FORMAT_PERCENT,	/* 0%, 0.00%, ... */
+	FAST_FORMAT_DATE	/* yyyy-mm-dd, yyyy/mm/dd */
+} FastFormatKind;
+
+typedef struct {
+	FastFormatKind kind;
+	int decimals;
+	gboolean grouping;
+	char date_sep;
+} FastFormat;
+
+/* Integers below this are handled by the fast path.  */
+#define FAST_FORMAT_MAX 1e9
+
+static void
+fast_format_classify (GOFormat const *format, FastFormat *ff)
+{
+	char const *xl;
+
+	ff->kind = FAST_FORMAT_NONE;
+	ff->decimals = 0;
+	ff->grouping = FALSE;
+	ff->date_sep = 0;
+
+	if (format == NULL || go_format_is_general (format)) {
+		ff->kind = FAST_FORMAT_NUMBER;
+		return;
+	}
+
+	xl = go_format_as_XL (format);
+	if (xl == NULL)
+		return;
+
+	if ((strcmp (xl, "yyyy-mm-dd") == 0 ||
+	     strcmp (xl, "yyyy/mm/dd") == 0)) {
+		ff->kind = FAST_FORMAT_DATE;
+		ff->date_sep = xl[4];
+		return;
+	}
+
+	if (strncmp (xl, "#,##", 4) == 0) {
+		ff->grouping = TRUE;
+		xl += 4;
+	}
+	if (*xl++ != '0')
+		return;
+	if (*xl == '.') {
+		xl++;
+		while (*xl == '0' && ff->decimals < 15) {
+			ff->decimals++;
+			xl++;
+		}
+		if (ff->decimals == 0)
+			return;
+	}
+	if (*xl == '%') {
+		ff->kind = FAST_FORMAT_PERCENT;
+		xl++;
+	} else
+		ff->kind = FAST_FORMAT_NUMBER;
+	if (*xl != 0)
+		ff->kind = FAST_FORMAT_NONE;
+}
+
+static void
+fast_format_append_integer (GString *str, guint32 u, gboolean grouping)
+{
+	char buf[16];
+	int i = 0;
+	GString const *thousand = grouping ? go_locale_get_thousand () : NULL;
+
+	do {
+		buf[i++] = '0' + u % 10;
+		u /= 10;
+	} while (u);
+
+	while (i > 0) {
+		g_string_append_c (str, buf[--i]);
+		if (thousand && i > 0 && i % 3 == 0)
+			g_string_append_len (str, thousand->str, thousand->len);
+	}
+}
+
+static gboolean
+format_value_fast (GString *str, GOFormat const *format,
+		   gnm_float val, GODateConventions const *date_conv)
+{
+	FastFormat ff;
+
+	fast_format_classify (format, &ff);
+
+	switch (ff.kind) {
+	case FAST_FORMAT_NONE:
+	default:
+		return FALSE;
+
+	case FAST_FORMAT_PERCENT:
+		val *= 100;
+		/* Fall through */
+	case FAST_FORMAT_NUMBER:
+		if (val != gnm_floor (val) ||
+		    !(gnm_abs (val) < FAST_FORMAT_MAX) ||
+		    (val == 0 && signbit (val)))
+			return FALSE;
+		g_string_truncate (str, 0);
+		if (val < 0)
+			g_string_append_c (str, '-');
+		fast_format_append_integer (str, (guint32)gnm_abs (val),
+					    ff.grouping);
+		if (ff.decimals > 0) {
+			GString const *dec = go_locale_get_decimal ();
+			g_string_append_len (str, dec->str, dec->len);
+			go_string_append_c_n (str, '0', ff.decimals);
+		}
+		if (ff.kind == FAST_FORMAT_PERCENT)
+			g_string_append_c (str, '%');
+		return TRUE;
+
+	case FAST_FORMAT_DATE: {
+		GDate date;
+
+		/* Stay clear of the 1900 leap year bug.  */
+		if (date_conv == NULL ||
+		    val != gnm_floor (val) || val < 61 || val >= 2958466)
+			return FALSE;
+		go_date_serial_to_g (&date, (int)val, date_conv);
+		if (!g_date_valid (&date) || g_date_get_year (&date) > 9999)
+			return FALSE;
+		g_string_printf (str, "%04d%c%02d%c%02d",
+				 g_date_get_year (&date), ff.date_sep,
+				 g_date_get_month (&date), ff.date_sep,
+				 g_date_get_day (&date));
+		return TRUE;
+	}
+	}
+}
+
+/* ------------------------------------------------------------------------- */
+
 static GOFormatNumberError
 format_value_common (PangoLayout *layout, GString *str,
 		     const GOFormatMeasure measure,
@@ -117,6 +270,9 @@ format_value_common (PangoLayout *layout, GString *str,
 		val = value_get_as_float (value);
 		type = 'F';
 		sval = NULL;
+		if (layout == NULL && col_width < 0 &&
+		    format_value_fast (str, format, val, date_conv))
+			return GO_FORMAT_NUMBER_OK;
 	} else {
 		val = 0;
 		/* Close enough: */
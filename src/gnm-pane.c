@@ -1389,6 +1389,9 @@ gnm_pane_compute_visible_region (GnmPane *pane,
 	if (full_recompute) {
 		gint64 col_offset = pane->first_offset.x = scg_colrow_distance_get (scg,
 										   TRUE, 0, pane->first.col);
+		if (pane->grid)
+			gnm_item_grid_flush_tiles (pane->grid);
+
 		if (NULL != pane->col.canvas)
 			goc_canvas_scroll_to (pane->col.canvas, col_offset / canvas->pixels_per_unit, 0);
 
@@ -1489,6 +1492,9 @@ gnm_pane_redraw_range (GnmPane *pane, GnmRange const *r)
 	scg = pane->simple.scg;
 	sheet = scg_sheet (scg);
 
+	/* Cached tiles can cover cells that have scrolled out of view.  */
+	gnm_item_grid_invalidate_range (pane->grid, r);
+
 	if ((r->end.col < pane->first.col) ||
 	    (r->end.row < pane->first.row) ||
 	    (r->start.col > pane->last_visible.col) ||
@@ -11,6 +11,13 @@ G_BEGIN_DECLS
 #define GNM_MAX_ROWS 0x1000000
 #define GNM_MAX_COLS 0x4000
 
+/*
+ * Row maximum with the huge-sheets debug flag.  Row offsets in pixels are
+ * ints and the pane is limited to GNM_PANE_MAX_Y, so this cannot grow
+ * much without changing those.  See gnm_sheet_max_rows_limit.
+ */
+#define GNM_HUGE_MAX_ROWS 0x4000000
+
 /* Standard size */
 #define GNM_DEFAULT_COLS 0x100
 #define GNM_DEFAULT_ROWS 0x10000
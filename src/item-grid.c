@@ -37,6 +37,7 @@
 #include <commands.h>
 #include <hlink.h>
 #include <gui-util.h>
+#include <gutils.h>
 #include <gnm-i18n.h>
 
 #include <goffice/goffice.h>
@@ -85,6 +86,11 @@ struct _GnmItemGrid {
 	GdkRGBA pane_divider_color;
 	int pane_divider_width;
 
+	/* Off-screen cache of rendered tiles, see ig_tiles_draw.  */
+	GHashTable *tiles;
+	double tiles_scale;
+	GnmCell const *tiles_edit_cell;
+	gboolean tiles_draw_selection;
 };
 typedef GocItemClass GnmItemGridClass;
 static GocItemClass *parent_class;
@@ -129,6 +135,208 @@ ig_reload_style (GnmItemGrid *ig)
 			      NULL);
 }
 
+/* ------------------------------------------------------------------------- */
+/*
+ * The tile cache keeps rendered IG_TILE_SIZE x IG_TILE_SIZE pixel blocks
+ * of the grid, keyed by their position in (zoomed) sheet pixels.  Scrolling
+ * then mostly blits tiles that were already rendered.  Tiles are dropped
+ * when the area they cover is damaged (gnm_item_grid_invalidate_tiles),
+ * and the whole cache goes when zoom, layout or theme change.
+ *
+ * This is experimental and only enabled with the grid-tile-cache debug
+ * flag.
+ */
+
+#define IG_TILE_SIZE 256
+#define IG_TILE_MAX 128
+
+static gboolean
+ig_tiles_enabled (void)
+{
+	static int enabled = -1;
+	if (enabled < 0)
+		enabled = gnm_debug_flag ("grid-tile-cache");
+	return enabled;
+}
+
+static gint64
+ig_tile_index (gint64 pixel)
+{
+	/* Floor division */
+	return pixel >= 0
+		? pixel / IG_TILE_SIZE
+		: -((-pixel + IG_TILE_SIZE - 1) / IG_TILE_SIZE);
+}
+
+static gint64 *
+ig_tile_key (gint64 tx, gint64 ty)
+{
+	gint64 *key = g_new (gint64, 1);
+	*key = (gint64)(((guint64)(guint32)tx << 32) | (guint32)ty);
+	return key;
+}
+
+/**
+ * gnm_item_grid_flush_tiles:
+ * @ig: #GnmItemGrid
+ *
+ * Discard all cached tiles.
+ */
+void
+gnm_item_grid_flush_tiles (GnmItemGrid *ig)
+{
+	g_return_if_fail (GNM_IS_ITEM_GRID (ig));
+
+	if (ig->tiles)
+		g_hash_table_remove_all (ig->tiles);
+}
+
+/**
+ * gnm_item_grid_invalidate_tiles:
+ * @ig: #GnmItemGrid
+ * @x0: left edge in sheet pixels
+ * @y0: top edge in sheet pixels
+ * @x1: right edge in sheet pixels, exclusive
+ * @y1: bottom edge in sheet pixels, exclusive
+ *
+ * Discard the cached tiles that intersect the given area.
+ */
+void
+gnm_item_grid_invalidate_tiles (GnmItemGrid *ig,
+				gint64 x0, gint64 y0, gint64 x1, gint64 y1)
+{
+	GHashTableIter iter;
+	gpointer key;
+	gint64 tx0, ty0, tx1, ty1;
+
+	g_return_if_fail (GNM_IS_ITEM_GRID (ig));
+
+	if (ig->tiles == NULL || g_hash_table_size (ig->tiles) == 0)
+		return;
+
+	tx0 = ig_tile_index (x0);
+	ty0 = ig_tile_index (y0);
+	tx1 = ig_tile_index (x1 - 1);
+	ty1 = ig_tile_index (y1 - 1);
+
+	g_hash_table_iter_init (&iter, ig->tiles);
+	while (g_hash_table_iter_next (&iter, &key, NULL)) {
+		gint64 k = *(gint64 *)key;
+		gint64 tx = (gint32)(k >> 32);
+		gint64 ty = (gint32)(k & 0xffffffff);
+		if (tx >= tx0 && tx <= tx1 && ty >= ty0 && ty <= ty1)
+			g_hash_table_iter_remove (&iter);
+	}
+}
+
+/**
+ * gnm_item_grid_invalidate_range:
+ * @ig: #GnmItemGrid
+ * @r: #GnmRange that was damaged
+ *
+ * Discard the cached tiles covering @r, including the parts of it that
+ * are not visible right now.
+ */
+void
+gnm_item_grid_invalidate_range (GnmItemGrid *ig, GnmRange const *r)
+{
+	GnmPane *pane;
+	Sheet const *sheet;
+	gint64 x1, y1, x2, y2;
+
+	g_return_if_fail (GNM_IS_ITEM_GRID (ig));
+	g_return_if_fail (r != NULL);
+
+	if (ig->tiles == NULL || g_hash_table_size (ig->tiles) == 0)
+		return;
+
+	pane = GNM_PANE (GOC_ITEM (ig)->canvas);
+	sheet = scg_sheet (ig->scg);
+
+	/* Measure from the first visible cell, as gnm_pane_redraw_range.  */
+	x1 = pane->first_offset.x +
+		scg_colrow_distance_get (ig->scg, TRUE, pane->first.col, r->start.col);
+	y1 = pane->first_offset.y +
+		scg_colrow_distance_get (ig->scg, FALSE, pane->first.row, r->start.row);
+	x2 = (r->end.col < gnm_sheet_get_last_col (sheet))
+		? 4 + 1 + x1 + scg_colrow_distance_get (ig->scg, TRUE,
+							r->start.col, r->end.col + 1)
+		: G_MAXINT64;
+	y2 = (r->end.row < gnm_sheet_get_last_row (sheet))
+		? 4 + 1 + y1 + scg_colrow_distance_get (ig->scg, FALSE,
+							r->start.row, r->end.row + 1)
+		: G_MAXINT64;
+
+	gnm_item_grid_invalidate_tiles (ig, x1 - 2, y1 - 2, x2, y2);
+}
+
+static gboolean
+item_grid_draw_region_real (GocItem const *item, cairo_t *cr,
+			    double x_0, double y_0, double x_1, double y_1);
+
+/*
+ * Draw the given area, in sheet pixels, by blitting cached tiles and
+ * rendering those that are missing.
+ */
+static void
+ig_tiles_draw (GnmItemGrid *ig, cairo_t *cr,
+	       gint64 x0, gint64 y0, gint64 x1, gint64 y1)
+{
+	GocCanvas *canvas = ig->canvas_item.canvas;
+	double scale = canvas->pixels_per_unit;
+	double sx = canvas->scroll_x1 * scale;
+	double sy = canvas->scroll_y1 * scale;
+	gint64 tx, ty;
+	gint64 tx0 = ig_tile_index (x0), tx1 = ig_tile_index (x1 - 1);
+	gint64 ty0 = ig_tile_index (y0), ty1 = ig_tile_index (y1 - 1);
+
+	if (g_hash_table_size (ig->tiles) +
+	    (tx1 - tx0 + 1) * (ty1 - ty0 + 1) > IG_TILE_MAX)
+		g_hash_table_remove_all (ig->tiles);
+
+	cairo_save (cr);
+	cairo_rectangle (cr, x0 - sx, y0 - sy, x1 - x0, y1 - y0);
+	cairo_clip (cr);
+
+	for (ty = ty0; ty <= ty1; ty++) {
+		for (tx = tx0; tx <= tx1; tx++) {
+			gint64 *key = ig_tile_key (tx, ty);
+			cairo_surface_t *tile = g_hash_table_lookup (ig->tiles, key);
+			gint64 px = tx * IG_TILE_SIZE, py = ty * IG_TILE_SIZE;
+
+			if (tile == NULL) {
+				cairo_t *tcr;
+
+				tile = cairo_surface_create_similar
+					(cairo_get_target (cr),
+					 CAIRO_CONTENT_COLOR_ALPHA,
+					 IG_TILE_SIZE, IG_TILE_SIZE);
+				tcr = cairo_create (tile);
+				cairo_rectangle (tcr, 0, 0,
+						 IG_TILE_SIZE, IG_TILE_SIZE);
+				cairo_clip (tcr);
+				/* Map widget coordinates onto the tile.  */
+				cairo_translate (tcr, sx - px, sy - py);
+				item_grid_draw_region_real
+					(GOC_ITEM (ig), tcr,
+					 px / scale, py / scale,
+					 (px + IG_TILE_SIZE) / scale,
+					 (py + IG_TILE_SIZE) / scale);
+				cairo_destroy (tcr);
+				g_hash_table_insert (ig->tiles, key, tile);
+			} else
+				g_free (key);
+
+			cairo_set_source_surface (cr, tile, px - sx, py - sy);
+			cairo_paint (cr);
+		}
+	}
+
+	cairo_restore (cr);
+}
+
+/* ------------------------------------------------------------------------- */
+
 static void
 ig_clear_hlink_tip (GnmItemGrid *ig)
 {
@@ -155,6 +363,11 @@ item_grid_finalize (GObject *object)
 	ig_clear_hlink_tip (ig);
 	ig->cur_link = NULL;
 
+	if (ig->tiles) {
+		g_hash_table_destroy (ig->tiles);
+		ig->tiles = NULL;
+	}
+
 	(*G_OBJECT_CLASS (parent_class)->finalize) (object);
 }
 
@@ -202,6 +415,7 @@ item_grid_realize (GocItem *item)
 
 	ig = GNM_ITEM_GRID (item);
 	ig_reload_style (ig);
+	gnm_item_grid_flush_tiles (ig);
 
 	display = gtk_widget_get_display (GTK_WIDGET (item->canvas));
 	ig->cursor_link  = gdk_cursor_new_for_display (display, GDK_HAND2);
@@ -222,6 +436,7 @@ item_grid_unrealize (GocItem *item)
 	GnmItemGrid *ig = GNM_ITEM_GRID (item);
 	g_clear_object (&ig->cursor_link);
 	g_clear_object (&ig->cursor_cross);
+	gnm_item_grid_flush_tiles (ig);
 	parent_class->unrealize (item);
 }
 
@@ -347,7 +562,7 @@ item_grid_draw_merged_range (cairo_t *cr, GnmItemGrid *ig,
 	if (cell != NULL) {
 		ColRowInfo *ri = sheet_row_get (sheet, range->start.row);
 
-		if (ri->needs_respan)
+		if (row_needs_respan (ri, sheet))
 			row_calc_spans (ri, cell->pos.row, sheet);
 
 		if (dir > 0) {
@@ -422,6 +637,52 @@ ig_cairo_draw_bound (GnmItemGrid *ig, cairo_t* cr, int x0, int y0, int x1, int y
 static gboolean
 item_grid_draw_region (GocItem const *item, cairo_t *cr,
 		       double x_0, double y_0, double x_1, double y_1)
+{
+	GocCanvas *canvas = item->canvas;
+	double scale = canvas->pixels_per_unit;
+	GnmItemGrid *ig = GNM_ITEM_GRID (item);
+	GnmPane *pane = GNM_PANE (canvas);
+	Sheet const *sheet = scg_sheet (pane->simple.scg);
+	WBCGtk *wbcg = scg_wbcg (pane->simple.scg);
+	GnmCell const *edit_cell = wbcg->editing_cell;
+	gboolean draw_selection =
+		ig->scg->selected_objects == NULL &&
+		wbcg->new_object == NULL;
+
+	/*
+	 * The pane divider lines of frozen panes are drawn relative to
+	 * the viewport and right-to-left layouts mirror coordinates, so
+	 * neither can be cached in sheet-pixel tiles.
+	 */
+	if (!ig_tiles_enabled () ||
+	    sheet->text_is_rtl ||
+	    canvas->direction != GOC_DIRECTION_LTR ||
+	    ig->bound.start.col > 0 || ig->bound.start.row > 0)
+		return item_grid_draw_region_real (item, cr,
+						   x_0, y_0, x_1, y_1);
+
+	if (ig->tiles == NULL)
+		ig->tiles = g_hash_table_new_full
+			(g_int64_hash, g_int64_equal,
+			 g_free, (GDestroyNotify)cairo_surface_destroy);
+
+	if (ig->tiles_scale != scale ||
+	    ig->tiles_edit_cell != edit_cell ||
+	    ig->tiles_draw_selection != draw_selection) {
+		g_hash_table_remove_all (ig->tiles);
+		ig->tiles_scale = scale;
+		ig->tiles_edit_cell = edit_cell;
+		ig->tiles_draw_selection = draw_selection;
+	}
+
+	ig_tiles_draw (ig, cr, x_0 * scale, y_0 * scale,
+		       x_1 * scale, y_1 * scale);
+	return TRUE;
+}
+
+static gboolean
+item_grid_draw_region_real (GocItem const *item, cairo_t *cr,
+			    double x_0, double y_0, double x_1, double y_1)
 {
 	GocCanvas *canvas = item->canvas;
 	double scale = canvas->pixels_per_unit;
@@ -510,7 +771,7 @@ item_grid_draw_region (GocItem const *item, cairo_t *cr,
 	/* Respan all rows that need it.  */
 	for (row = start_row; row <= end_row; row++) {
 		ColRowInfo const *ri = sheet_row_get_info (sheet, row);
-		if (ri->visible && ri->needs_respan)
+		if (ri->visible && row_needs_respan (ri, sheet))
 			row_calc_spans ((ColRowInfo *)ri, row, sheet);
 	}
 
@@ -1220,7 +1481,7 @@ gnm_item_grid_init (GnmItemGrid *ig)
 	/* We need something at least as big as any sheet.  */
 	ig->bound.start.col = ig->bound.start.row = 0;
 	ig->bound.end.col = GNM_MAX_COLS - 1;
-	ig->bound.end.row = GNM_MAX_ROWS - 1;
+	ig->bound.end.row = gnm_sheet_max_rows_limit () - 1;
 	ig->cursor_timer = 0;
 	ig->cur_link = NULL;
 	ig->tip_timer = 0;
@@ -1243,6 +1504,7 @@ item_grid_set_property (GObject *obj, guint param_id,
 		r = g_value_get_pointer (value);
 		g_return_if_fail (r != NULL);
 		ig->bound =  *r;
+		gnm_item_grid_flush_tiles (ig);
 		break;
 	}
 }
@@ -11,6 +11,12 @@ G_BEGIN_DECLS
 
 GType gnm_item_grid_get_type (void);
 
+void gnm_item_grid_flush_tiles      (GnmItemGrid *ig);
+void gnm_item_grid_invalidate_tiles (GnmItemGrid *ig,
+				     gint64 x0, gint64 y0,
+				     gint64 x1, gint64 y1);
+void gnm_item_grid_invalidate_range (GnmItemGrid *ig, GnmRange const *r);
+
 G_END_DECLS
 
 #endif /* _GNM_ITEM_GRID_H_ */
@@ -873,6 +873,71 @@ gnm_float qnorm(gnm_float p, gnm_float mu, gnm_float sigma, gboolean lower_tail,
     return mu + sigma * val;
 }
 
+/* ------------------------------------------------------------------------ */
+
+/*
+ * Batch versions of the above.  These transform @xs in place and give the
+ * same results as calling the scalar function on each element, but check
+ * the parameters only once and keep the inner loop free of calls back
+ * into the evaluator.
+ */
+
+void
+pnorm_vec (gnm_float *xs, int n, gnm_float mu, gnm_float sigma,
+	   gboolean lower_tail, gboolean log_p)
+{
+	int i;
+
+	if (gnm_isnan (mu) || gnm_isnan (sigma) || sigma <= 0 ||
+	    !gnm_finite (mu) || !gnm_finite (sigma)) {
+		for (i = 0; i < n; i++)
+			xs[i] = pnorm (xs[i], mu, sigma, lower_tail, log_p);
+		return;
+	}
+
+	for (i = 0; i < n; i++) {
+		gnm_float x = xs[i], p, cp = 0;
+
+		if (gnm_isnan (x))
+			continue;
+		x = (x - mu) / sigma;
+		if (!gnm_finite (x)) {
+			xs[i] = (x < 0) ? R_DT_0 : R_DT_1;
+			continue;
+		}
+		pnorm_both (x, &p, &cp, (lower_tail ? 0 : 1), log_p);
+		xs[i] = lower_tail ? p : cp;
+	}
+}
+
+void
+qnorm_vec (gnm_float *ps, int n, gnm_float mu, gnm_float sigma,
+	   gboolean lower_tail, gboolean log_p)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		ps[i] = qnorm (ps[i], mu, sigma, lower_tail, log_p);
+}
+
+void
+gnm_exp_vec (gnm_float *xs, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		xs[i] = gnm_exp (xs[i]);
+}
+
+void
+gnm_log_vec (gnm_float *xs, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		xs[i] = gnm_log (xs[i]);
+}
+
 
 /* ------------------------------------------------------------------------ */
 /* Imported src/nmath/ppois.c from R.  */
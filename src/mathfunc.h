@@ -39,6 +39,8 @@ gnm_float gnm_logcf (gnm_float x, gnm_float i, gnm_float d);
 gnm_float expmx2h (gnm_float x);
 gnm_float gnm_agm(gnm_float a, gnm_float b);
 gnm_float gnm_lambert_w(gnm_float x, int k);
+void gnm_exp_vec (gnm_float *xs, int n);
+void gnm_log_vec (gnm_float *xs, int n);
 
 /* "d": density.  */
 /* "p": distribution function.  */
@@ -47,6 +49,8 @@ gnm_float gnm_lambert_w(gnm_float x, int k);
 /* The normal distribution.  */
 gnm_float pnorm (gnm_float x, gnm_float mu, gnm_float sigma, gboolean lower_tail, gboolean log_p);
 gnm_float qnorm (gnm_float p, gnm_float mu, gnm_float sigma, gboolean lower_tail, gboolean log_p);
+void pnorm_vec (gnm_float *xs, int n, gnm_float mu, gnm_float sigma, gboolean lower_tail, gboolean log_p);
+void qnorm_vec (gnm_float *ps, int n, gnm_float mu, gnm_float sigma, gboolean lower_tail, gboolean log_p);
 
 /* The gamma distribution.  */
 gnm_float dgamma (gnm_float x, gnm_float shape, gnm_float scale, gboolean give_log);
@@ -1105,6 +1105,13 @@ gnm_style_equal (GnmStyle const *a, GnmStyle const *b)
 
 	if (a == b)
 		return TRUE;
+	/*
+	 * When both hash keys are current, differing keys settle the
+	 * question without looking at the elements.  This is the common
+	 * case for collision chains in the sheet style hash.
+	 */
+	if (!a->changed && !b->changed && a->hash_key != b->hash_key)
+		return FALSE;
 	if (a->set != b->set || !gnm_style_equal_XL (a, b))
 		return FALSE;
 	UNROLLED_FOR (i = MSTYLE_VALIDATION, i < MSTYLE_ELEMENT_MAX, i++, {
@@ -1126,6 +1133,9 @@ gnm_style_equal_XL (GnmStyle const *a, GnmStyle const *b)
 	if (a == b)
 		return TRUE;
 
+	if (!a->changed && !b->changed && a->hash_key_xl != b->hash_key_xl)
+		return FALSE;
+
 	if ((a->set ^ b->set) & ((1u << MSTYLE_VALIDATION) - 1))
 		return FALSE;
 
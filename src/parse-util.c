@@ -1402,8 +1402,8 @@ std_sheet_name_quote (GnmConventions const *convs,
 	}
 
 	if (ndigits > 0) {
-		static const GnmSheetSize max_size = {
-			GNM_MAX_COLS, GNM_MAX_ROWS
+		GnmSheetSize const max_size = {
+			GNM_MAX_COLS, gnm_sheet_max_rows_limit ()
 		};
 		/*
 		 * Excel also quotes things that look like cell references.
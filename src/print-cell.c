@@ -267,7 +267,7 @@ print_merged_range_gtk (cairo_t *context,
 	if (cell != NULL) {
 		ColRowInfo *ri = sheet_row_get (sheet, range->start.row);
 
-		if (ri->needs_respan)
+		if (row_needs_respan (ri, sheet))
 			row_calc_spans (ri, cell->pos.row, sheet);
 
 		if (sheet->text_is_rtl)
@@ -397,7 +397,7 @@ gnm_gtk_print_cell_range (cairo_t *context,
 		/* it is safe to const_cast because only a non-default row
 		 * will ever get flagged.
 		 */
-		if (ri->needs_respan)
+		if (row_needs_respan (ri, sheet))
 			row_calc_spans ((ColRowInfo *)ri, row, sheet);
 
 		/* look for merges that start on this row, on the first painted row
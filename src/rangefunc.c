@@ -18,6 +18,119 @@
 #include <string.h>
 #include <tools/analysis-tools.h>
 
+/*
+ * The sums below are kept in RANGE_LANES independent partial sums, each
+ * with Kahan compensation.  Independent lanes break the dependency chain
+ * of a single accumulator, which lets the compiler vectorize the loops and
+ * the CPU overlap the additions.  The compensation keeps the rounding error
+ * from growing with the number of terms.
+ */
+#define RANGE_LANES 4
+
+typedef struct {
+	gnm_float sum[RANGE_LANES];
+	gnm_float c[RANGE_LANES];
+} RangeLanes;
+
+static inline void
+range_lanes_add (RangeLanes *acc, int j, gnm_float x)
+{
+	gnm_float y = x - acc->c[j];
+	gnm_float t = acc->sum[j] + y;
+	acc->c[j] = (t - acc->sum[j]) - y;
+	acc->sum[j] = t;
+}
+
+static gnm_float
+range_lanes_total (RangeLanes const *acc)
+{
+	RangeLanes tot = { { 0 }, { 0 } };
+	int j;
+
+	for (j = 0; j < RANGE_LANES; j++) {
+		range_lanes_add (&tot, 0, acc->sum[j]);
+		range_lanes_add (&tot, 0, -acc->c[j]);
+	}
+
+	return tot.sum[0] - tot.c[0];
+}
+
+/* Sum of |x-m|.  */
+static gnm_float
+range_sum_absdev (gnm_float const *xs, int n, gnm_float m)
+{
+	RangeLanes acc = { { 0 }, { 0 } };
+	int i, j;
+
+	for (i = 0; i + RANGE_LANES <= n; i += RANGE_LANES)
+		for (j = 0; j < RANGE_LANES; j++)
+			range_lanes_add (&acc, j, gnm_abs (xs[i + j] - m));
+	for (; i < n; i++)
+		range_lanes_add (&acc, 0, gnm_abs (xs[i] - m));
+
+	return range_lanes_total (&acc);
+}
+
+/* Sum of ((x-m)/s)^3.  */
+static gnm_float
+range_sum_cubed_z (gnm_float const *xs, int n, gnm_float m, gnm_float s)
+{
+	RangeLanes acc = { { 0 }, { 0 } };
+	int i, j;
+
+	for (i = 0; i + RANGE_LANES <= n; i += RANGE_LANES) {
+		for (j = 0; j < RANGE_LANES; j++) {
+			gnm_float dxn = (xs[i + j] - m) / s;
+			range_lanes_add (&acc, j, dxn * dxn * dxn);
+		}
+	}
+	for (; i < n; i++) {
+		gnm_float dxn = (xs[i] - m) / s;
+		range_lanes_add (&acc, 0, dxn * dxn * dxn);
+	}
+
+	return range_lanes_total (&acc);
+}
+
+/* Sum of ((x-m)/s)^4.  */
+static gnm_float
+range_sum_fourth_z (gnm_float const *xs, int n, gnm_float m, gnm_float s)
+{
+	RangeLanes acc = { { 0 }, { 0 } };
+	int i, j;
+
+	for (i = 0; i + RANGE_LANES <= n; i += RANGE_LANES) {
+		for (j = 0; j < RANGE_LANES; j++) {
+			gnm_float dxn = (xs[i + j] - m) / s;
+			range_lanes_add (&acc, j, (dxn * dxn) * (dxn * dxn));
+		}
+	}
+	for (; i < n; i++) {
+		gnm_float dxn = (xs[i] - m) / s;
+		range_lanes_add (&acc, 0, (dxn * dxn) * (dxn * dxn));
+	}
+
+	return range_lanes_total (&acc);
+}
+
+/* Sum of (x-ux)*(y-uy).  */
+static gnm_float
+range_sum_devprod (gnm_float const *xs, gnm_float const *ys, int n,
+		   gnm_float ux, gnm_float uy)
+{
+	RangeLanes acc = { { 0 }, { 0 } };
+	int i, j;
+
+	for (i = 0; i + RANGE_LANES <= n; i += RANGE_LANES)
+		for (j = 0; j < RANGE_LANES; j++)
+			range_lanes_add (&acc, j,
+					 (xs[i + j] - ux) * (ys[i + j] - uy));
+	for (; i < n; i++)
+		range_lanes_add (&acc, 0, (xs[i] - ux) * (ys[i] - uy));
+
+	return range_lanes_total (&acc);
+}
+
 int
 gnm_range_count (G_GNUC_UNUSED gnm_float const *xs, int n, gnm_float *res)
 {
@@ -51,13 +164,10 @@ int
 gnm_range_avedev (gnm_float const *xs, int n, gnm_float *res)
 {
 	if (n > 0) {
-		gnm_float m, s = 0;
-		int i;
+		gnm_float m;
 
 		gnm_range_average (xs, n, &m);
-		for (i = 0; i < n; i++)
-			s += gnm_abs (xs[i] - m);
-		*res = s / n;
+		*res = range_sum_absdev (xs, n, m) / n;
 		return 0;
 	} else
 		return 1;
@@ -119,18 +229,14 @@ gnm_range_stddev_est (gnm_float const *xs, int n, gnm_float *res)
 int
 gnm_range_skew_pop (gnm_float const *xs, int n, gnm_float *res)
 {
-	gnm_float m, s, dxn, x3 = 0;
-	int i;
+	gnm_float m, s, x3;
 
 	if (n < 1 || gnm_range_average (xs, n, &m) || gnm_range_stddev_pop (xs, n, &s))
 		return 1;
 	if (s == 0)
 		return 1;
 
-	for (i = 0; i < n; i++) {
-		dxn = (xs[i] - m) / s;
-		x3 += dxn * dxn *dxn;
-	}
+	x3 = range_sum_cubed_z (xs, n, m, s);
 
 	*res = x3 / n;
 	return 0;
@@ -140,18 +246,14 @@ gnm_range_skew_pop (gnm_float const *xs, int n, gnm_float *res)
 int
 gnm_range_skew_est (gnm_float const *xs, int n, gnm_float *res)
 {
-	gnm_float m, s, dxn, x3 = 0;
-	int i;
+	gnm_float m, s, x3;
 
 	if (n < 3 || gnm_range_average (xs, n, &m) || gnm_range_stddev_est (xs, n, &s))
 		return 1;
 	if (s == 0)
 		return 1;
 
-	for (i = 0; i < n; i++) {
-		dxn = (xs[i] - m) / s;
-		x3 += dxn * dxn *dxn;
-	}
+	x3 = range_sum_cubed_z (xs, n, m, s);
 
 	*res = ((x3 * n) / (n - 1)) / (n - 2);
 	return 0;
@@ -161,18 +263,14 @@ gnm_range_skew_est (gnm_float const *xs, int n, gnm_float *res)
 int
 gnm_range_kurtosis_m3_pop (gnm_float const *xs, int n, gnm_float *res)
 {
-	gnm_float m, s, dxn, x4 = 0;
-	int i;
+	gnm_float m, s, x4;
 
 	if (n < 1 || gnm_range_average (xs, n, &m) || gnm_range_stddev_pop (xs, n, &s))
 		return 1;
 	if (s == 0)
 		return 1;
 
-	for (i = 0; i < n; i++) {
-		dxn = (xs[i] - m) / s;
-		x4 += (dxn * dxn) * (dxn * dxn);
-	}
+	x4 = range_sum_fourth_z (xs, n, m, s);
 
 	*res = x4 / n - 3;
 	return 0;
@@ -182,19 +280,15 @@ gnm_range_kurtosis_m3_pop (gnm_float const *xs, int n, gnm_float *res)
 int
 gnm_range_kurtosis_m3_est (gnm_float const *xs, int n, gnm_float *res)
 {
-	gnm_float m, s, dxn, x4 = 0;
+	gnm_float m, s, x4;
 	gnm_float common_den, nth, three;
-	int i;
 
 	if (n < 4 || gnm_range_average (xs, n, &m) || gnm_range_stddev_est (xs, n, &s))
 		return 1;
 	if (s == 0)
 		return 1;
 
-	for (i = 0; i < n; i++) {
-		dxn = (xs[i] - m) / s;
-		x4 += (dxn * dxn) * (dxn * dxn);
-	}
+	x4 = range_sum_fourth_z (xs, n, m, s);
 
 	common_den = (gnm_float)(n - 2) * (n - 3);
 	nth = (gnm_float)n * (n + 1) / ((n - 1) * common_den);
@@ -350,15 +444,12 @@ gnm_range_multinomial (gnm_float const *xs, int n, gnm_float *res)
 int
 gnm_range_covar_pop (gnm_float const *xs, const gnm_float *ys, int n, gnm_float *res)
 {
-	gnm_float ux, uy, s = 0;
-	int i;
+	gnm_float ux, uy;
 
 	if (n <= 0 || gnm_range_average (xs, n, &ux) || gnm_range_average (ys, n, &uy))
 		return 1;
 
-	for (i = 0; i < n; i++)
-		s += (xs[i] - ux) * (ys[i] - uy);
-	*res = s / n;
+	*res = range_sum_devprod (xs, ys, n, ux, uy) / n;
 	return 0;
 }
 
@@ -366,15 +457,12 @@ gnm_range_covar_pop (gnm_float const *xs, const gnm_float *ys, int n, gnm_float
 int
 gnm_range_covar_est (gnm_float const *xs, const gnm_float *ys, int n, gnm_float *res)
 {
-	gnm_float ux, uy, s = 0;
-	int i;
+	gnm_float ux, uy;
 
 	if (n <= 1 || gnm_range_average (xs, n, &ux) || gnm_range_average (ys, n, &uy))
 		return 1;
 
-	for (i = 0; i < n; i++)
-		s += (xs[i] - ux) * (ys[i] - uy);
-	*res = s / (n - 1);
+	*res = range_sum_devprod (xs, ys, n, ux, uy) / (n - 1);
 	return 0;
 }
 
@@ -462,6 +550,139 @@ gnm_range_mode (gnm_float const *xs, int n, gnm_float *res)
 	return 0;
 }
 
+static int
+float_compare (const void *a_, const void *b_)
+{
+	gnm_float const *a = a_;
+	gnm_float const *b = b_;
+
+	if (*a < *b)
+		return -1;
+	else if (*a == *b)
+		return 0;
+	else
+		return 1;
+}
+
+/*
+ * Rearrange xs such that xs[k] holds the value it would have if xs were
+ * sorted, with no larger values before it and no smaller values after it.
+ * This is quickselect with median-of-three pivots.  Should partitioning
+ * keep going badly, the remaining part is simply sorted.
+ */
+static void
+range_select (gnm_float *xs, int n, int k)
+{
+	int lo = 0, hi = n - 1;
+	int budget = 0, m;
+
+	for (m = n; m > 0; m >>= 1)
+		budget += 2;
+
+#define SWAP(i_,j_) do { gnm_float t_ = xs[i_]; xs[i_] = xs[j_]; xs[j_] = t_; } while (0)
+
+	while (hi > lo) {
+		int i, j, mid;
+		gnm_float pivot;
+
+		if (budget-- == 0) {
+			qsort (xs + lo, hi - lo + 1, sizeof (xs[0]),
+			       float_compare);
+			break;
+		}
+
+		mid = lo + (hi - lo) / 2;
+		if (xs[mid] < xs[lo]) SWAP (mid, lo);
+		if (xs[hi] < xs[lo]) SWAP (hi, lo);
+		if (xs[hi] < xs[mid]) SWAP (hi, mid);
+		pivot = xs[mid];
+
+		i = lo;
+		j = hi;
+		while (i <= j) {
+			while (xs[i] < pivot)
+				i++;
+			while (xs[j] > pivot)
+				j--;
+			if (i <= j) {
+				SWAP (i, j);
+				i++;
+				j--;
+			}
+		}
+
+		/*
+		 * Now [lo,j] <= pivot <= [i,hi] and anything in between
+		 * equals the pivot.
+		 */
+		if (k <= j)
+			hi = j;
+		else if (k >= i)
+			lo = i;
+		else
+			break;
+	}
+
+#undef SWAP
+}
+
+/**
+ * gnm_range_fractile_inter_nonsorted:
+ * @xs: (array length=n): values, which will be reordered
+ * @n: number of values
+ * @res: (out): result
+ * @f: fractile, between 0 and 1
+ *
+ * Like gnm_range_fractile_inter_sorted, but for data that has not been
+ * sorted.  This takes linear time on average.
+ *
+ * Returns: 0 on success, 1 on error.
+ */
+int
+gnm_range_fractile_inter_nonsorted (gnm_float *xs, int n, gnm_float *res,
+				    gnm_float f)
+{
+	int pos, i;
+
+	if (n <= 0 || !(f >= 0 && f <= 1))
+		return 1;
+
+	pos = (int)((n - 1) * f);
+	range_select (xs, n, pos);
+
+	/* The interpolation also needs the next value up.  */
+	if (pos + 1 < n) {
+		int m = pos + 1;
+		for (i = pos + 2; i < n; i++)
+			if (xs[i] < xs[m])
+				m = i;
+		if (m != pos + 1) {
+			gnm_float t = xs[m];
+			xs[m] = xs[pos + 1];
+			xs[pos + 1] = t;
+		}
+	}
+
+	return gnm_range_fractile_inter_sorted (xs, n, res, f);
+}
+
+/**
+ * gnm_range_median_inter_nonsorted:
+ * @xs: (array length=n): values, which will be reordered
+ * @n: number of values
+ * @res: (out): result
+ *
+ * Like gnm_range_median_inter_sorted, but for data that has not been
+ * sorted.
+ *
+ * Returns: 0 on success, 1 on error.
+ */
+int
+gnm_range_median_inter_nonsorted (gnm_float *xs, int n, gnm_float *res)
+{
+	return gnm_range_fractile_inter_nonsorted (xs, n, res, 0.5);
+}
+
 int
 gnm_range_adtest    (gnm_float const *xs, int n, gnm_float *pvalue,
 		     gnm_float *statistics)
@@ -73,6 +73,54 @@ gnm_search_normalize_result (const char *txt)
 
 /* ------------------------------------------------------------------------- */
 
+/*
+ * A literal search for ASCII text cannot match ASCII text that does not
+ * contain it as a substring.  Normalization leaves ASCII alone, so such
+ * cells can be rejected before normalizing and matching.
+ */
+static void
+gnm_search_literal_init (GnmSearchReplace *sr)
+{
+	GOSearchReplace *gosr = (GOSearchReplace *)sr;
+	char const *p;
+
+	g_free (sr->literal);
+	sr->literal = NULL;
+
+	if (gosr->is_regexp || gosr->search_text == NULL)
+		return;
+	for (p = gosr->search_text; *p; p++)
+		if ((guchar)*p >= 0x80)
+			return;
+	sr->literal = g_strdup (gosr->search_text);
+}
+
+static gboolean
+gnm_search_literal_may_match (GnmSearchReplace const *sr, char const *text)
+{
+	char const *lit = sr->literal;
+	char const *p;
+	size_t n;
+
+	if (lit == NULL)
+		return TRUE;
+
+	for (p = text; *p; p++)
+		if ((guchar)*p >= 0x80)
+			return TRUE;
+
+	if (!((GOSearchReplace const *)sr)->ignore_case)
+		return strstr (text, lit) != NULL;
+
+	n = strlen (lit);
+	for (p = text; *p; p++)
+		if (g_ascii_strncasecmp (p, lit, n) == 0)
+			return TRUE;
+	return n == 0;
+}
+
+/* ------------------------------------------------------------------------- */
+
 static gboolean
 check_number (GnmSearchReplace *sr)
 {
@@ -154,8 +202,10 @@ cb_order_sheet_row_col (void const *_a, void const *_b)
 	GnmEvalPos const *b = *(GnmEvalPos const **)_b;
 	int i;
 
-	i = strcmp (a->sheet->name_unquoted_collate_key,
-	            b->sheet->name_unquoted_collate_key);
+	i = a->sheet == b->sheet
+		? 0
+		: strcmp (a->sheet->name_unquoted_collate_key,
+			  b->sheet->name_unquoted_collate_key);
 
 	/* By row number.  */
 	if (!i) i = (a->eval.row - b->eval.row);
@@ -173,8 +223,10 @@ cb_order_sheet_col_row (void const *_a, void const *_b)
 	GnmEvalPos const *b = *(GnmEvalPos const **)_b;
 	int i;
 
-	i = strcmp (a->sheet->name_unquoted_collate_key,
-	            b->sheet->name_unquoted_collate_key);
+	i = a->sheet == b->sheet
+		? 0
+		: strcmp (a->sheet->name_unquoted_collate_key,
+			  b->sheet->name_unquoted_collate_key);
 
 	/* By column number.  */
 	if (!i) i = (a->eval.col - b->eval.col);
@@ -276,6 +328,7 @@ gnm_search_filter_matching (GnmSearchReplace *sr, const GPtrArray *cells)
 
 	if (sr->is_number)
 		check_number (sr);
+	gnm_search_literal_init (sr);
 
 	for (i = 0; i < cells->len; i++) {
 		GnmSearchReplaceCellResult cell_res;
@@ -310,6 +363,9 @@ gnm_search_filter_matching (GnmSearchReplace *sr, const GPtrArray *cells)
 		}
 	}
 
+	g_free (sr->literal);
+	sr->literal = NULL;
+
 	return result;
 }
 
@@ -352,6 +408,8 @@ gnm_search_replace_comment (GnmSearchReplace *sr,
 	if (!res->comment) return FALSE;
 
 	res->old_text = cell_comment_text_get (res->comment);
+	if (!repl && !gnm_search_literal_may_match (sr, res->old_text))
+		return FALSE;
 
 	norm_text = gnm_search_normalize (res->old_text);
 
@@ -418,6 +476,9 @@ gnm_search_replace_cell (GnmSearchReplace *sr,
 
 		res->old_text = gnm_cell_get_entered_text (cell);
 		initial_quote = (is_string && res->old_text[0] == '\'');
+		if (!repl &&
+		    !gnm_search_literal_may_match (sr, res->old_text + initial_quote))
+			return FALSE;
 
 		actual_src = gnm_search_normalize (res->old_text + initial_quote);
 
@@ -475,8 +536,14 @@ gnm_search_replace_value (GnmSearchReplace *sr,
 	else if (sr->is_number) {
 		return gnm_search_match_value (sr, cell->value);
 	} else {
-		char *val = gnm_search_normalize (value_peek_string (cell->value));
-		gboolean res = go_search_match_string (GO_SEARCH_REPLACE (sr), val);
+		char const *str = value_peek_string (cell->value);
+		char *val;
+		gboolean res;
+
+		if (!gnm_search_literal_may_match (sr, str))
+			return FALSE;
+		val = gnm_search_normalize (str);
+		res = go_search_match_string (GO_SEARCH_REPLACE (sr), val);
 		g_free (val);
 		return res;
 	}
@@ -690,6 +757,7 @@ gnm_search_replace_finalize (GObject *obj)
 
 	gnm_search_replace_set_sheet (sr, NULL);
 	g_free (sr->range_text);
+	g_free (sr->literal);
 
 	G_OBJECT_CLASS (parent_class)->finalize (obj);
 }
@@ -94,6 +94,9 @@ struct _GnmSearchReplace {
 	 */
 	GnmSearchReplaceQueryFunc query_func;
 	void *user_data;
+
+	/* ASCII search text used to reject cells quickly.  Private.  */
+	char *literal;
 };
 
 GType gnm_search_replace_get_type (void);
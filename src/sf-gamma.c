@@ -77,6 +77,18 @@ gnm_float lgamma1p (gnm_float a)
     return (a * lgam - eulers_const) * a - log1pmx (a);
 } /* lgamma1p */
 
+/*
+ * lgamma_vec: replace each element of @xs by log|Gamma(x)|.
+ */
+void
+lgamma_vec (gnm_float *xs, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		xs[i] = gnm_lgamma (xs[i]);
+}
+
 /* ------------------------------------------------------------------------ */
 
 /* Imported src/nmath/stirlerr.c from R.  */
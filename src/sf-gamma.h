@@ -5,6 +5,7 @@
 #include <complex.h>
 
 gnm_float lgamma1p (gnm_float a);
+void      lgamma_vec (gnm_float *xs, int n);
 gnm_float stirlerr(gnm_float n);
 
 gnm_float gnm_gamma (gnm_float x);
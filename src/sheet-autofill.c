@@ -807,6 +807,7 @@ typedef struct {
 	int size;
 	GnmCellPos last;
 	const GnmCell ** cells;
+	gboolean *plain;
 } AutoFillerCopy;
 
 static void
@@ -814,14 +815,43 @@ afc_finalize (AutoFiller *af)
 {
 	AutoFillerCopy *afe = (AutoFillerCopy *)af;
 	g_free (afe->cells);
+	g_free (afe->plain);
 	af_finalize (af);
 }
 
+static GnmExpr const *
+cb_afc_plain (GnmExpr const *expr, GnmExprWalk *data)
+{
+	if (GNM_EXPR_GET_OPER (expr) == GNM_EXPR_OP_NAME) {
+		*(gboolean *)data->user = FALSE;
+		data->stop = TRUE;
+	}
+	return NULL;
+}
+
+/*
+ * The relocation in afc_set_cell_hint has no sheets, so only names can
+ * change.  Expressions without names are copied as they are, sharing
+ * one expression for the whole fill.
+ */
+static gboolean
+afc_is_plain (GnmExprTop const *texpr)
+{
+	gboolean res = TRUE;
+
+	if (gnm_expr_top_is_array (texpr))
+		return FALSE;
+	gnm_expr_walk (texpr->expr, cb_afc_plain, &res);
+	return res;
+}
+
 static void
 afc_teach_cell (AutoFiller *af, const GnmCell *cell, int n)
 {
 	AutoFillerCopy *afe = (AutoFillerCopy *)af;
 	afe->cells[n] = cell;
+	afe->plain[n] = cell && gnm_cell_has_expr (cell) &&
+		afc_is_plain (cell->base.texpr);
 	if (n == afe->size - 1) {
 		/* This actually includes the all-empty case.  */
 		af->status = AFS_READY;
@@ -852,7 +882,9 @@ afc_set_cell_hint (AutoFiller *af, GnmCell *cell, GnmCellPos const *pos,
 		parse_pos_init (&rinfo.pos, sheet->workbook, sheet,
 			pos->col, pos->row);
 
-		texpr = gnm_expr_top_relocate (src_texpr, &rinfo, FALSE);
+		texpr = afe->plain[n % afe->size]
+			? NULL
+			: gnm_expr_top_relocate (src_texpr, &rinfo, FALSE);
 
 		/* Clip arrays that are only partially copied.  */
 		if (gnm_expr_top_is_array_corner (src_texpr)) {
@@ -948,6 +980,7 @@ auto_filler_copy (int size, guint last_col, guint last_row)
 	res->last.col = last_col;
 	res->last.row = last_row;
 	res->cells = g_new0 (GnmCell const *, size);
+	res->plain = g_new0 (gboolean, size);
 
 	return &res->filler;
 }
@@ -1128,6 +1161,23 @@ sheet_autofill_dir (Sheet *sheet, gboolean singleton,
 	if (!af) {
 		/* Strange, but no fill.  */
 	} else if (doit) {
+		/*
+		 * With a single style and no merges, the target gets its
+		 * style in one go rather than cell by cell.
+		 */
+		gboolean one_style = (i < count_max);
+		GnmRange fill;
+		int l;
+
+		for (l = 0; l < true_region_size; l++)
+			if (merges[l] || styles[l] != styles[0])
+				one_style = FALSE;
+		fill.start.col = base_col + i * col_inc;
+		fill.start.row = base_row + i * row_inc;
+		fill.end.col = base_col + (count_max - 1) * col_inc;
+		fill.end.row = base_row + (count_max - 1) * row_inc;
+		range_normalize (&fill);
+
 		while (i < count_max) {
 			int k = j % true_region_size;
 			int ms = merge_size[k];
@@ -1142,8 +1192,9 @@ sheet_autofill_dir (Sheet *sheet, gboolean singleton,
 			cell = sheet_cell_fetch (sheet, col, row);
 			af->set_cell (af, cell, j);
 
-			sheet_style_set_pos (sheet, col, row,
-					     gnm_style_dup (styles[k]));
+			if (!one_style)
+				sheet_style_set_pos (sheet, col, row,
+						     gnm_style_dup (styles[k]));
 			if (merges[k]) {
 				GnmRange r = *merges[k];
 				int ofs = (i / region_size) * region_size;
@@ -1155,6 +1206,10 @@ sheet_autofill_dir (Sheet *sheet, gboolean singleton,
 			i += (ms + 1);
 			j++;
 		}
+
+		if (one_style)
+			sheet_style_set_range (sheet, &fill,
+					       gnm_style_dup (styles[0]));
 	} else {
 		GnmCellPos pos;
 		int repeats = (count_max - 1) / region_size;
@@ -60,6 +60,7 @@
 #include <gnm-pane-impl.h>
 #include <item-bar.h>
 #include <item-cursor.h>
+#include <item-grid.h>
 #include <widgets/gnm-expr-entry.h>
 #include <gnm-sheet-slicer.h>
 #include <input-msg.h>
@@ -162,6 +163,7 @@ scg_redraw_all (SheetControl *sc, gboolean headers)
 	g_return_if_fail (GNM_IS_SCG (scg));
 
 	SCG_FOREACH_PANE (scg, pane, {
+		gnm_item_grid_flush_tiles (pane->grid);
 		goc_canvas_invalidate (GOC_CANVAS (pane),
 			G_MININT64, 0, G_MAXINT64, G_MAXINT64);
 		if (headers) {
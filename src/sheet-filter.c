@@ -173,12 +173,71 @@ gnm_filter_condition_get_type (void)
 
 /*****************************************************************************/
 
+/*
+ * Rows to hide are collected in a bitmap and hidden in runs at the end,
+ * rather than one colrow_set_visibility per row.  Rows marked by one field
+ * count as hidden for the fields applied after it.
+ */
+typedef struct {
+	Sheet	*target_sheet; /* not necessarilly the src */
+	int	 first, last;
+	guint8	*hide;
+} FilterRows;
+
+static void
+filter_rows_init (FilterRows *fr, Sheet *target_sheet, int first, int last)
+{
+	fr->target_sheet = target_sheet;
+	fr->first = first;
+	fr->last = last;
+	fr->hide = g_new0 (guint8, (last - first + 1 + 7) / 8);
+}
+
+static inline void
+filter_rows_hide (FilterRows *fr, int row)
+{
+	int i = row - fr->first;
+	fr->hide[i >> 3] |= 1 << (i & 7);
+}
+
+static inline gboolean
+filter_rows_is_hidden (FilterRows const *fr, int row)
+{
+	int i = row - fr->first;
+	return (fr->hide[i >> 3] >> (i & 7)) & 1;
+}
+
+static void
+filter_rows_commit (FilterRows *fr)
+{
+	int row = fr->first;
+
+	while (row <= fr->last) {
+		int end;
+
+		if (!filter_rows_is_hidden (fr, row)) {
+			row++;
+			continue;
+		}
+		for (end = row; end < fr->last; end++)
+			if (!filter_rows_is_hidden (fr, end + 1))
+				break;
+		colrow_set_visibility (fr->target_sheet, FALSE, FALSE, row, end);
+		row = end + 1;
+	}
+
+	g_free (fr->hide);
+	fr->hide = NULL;
+}
+
+/*****************************************************************************/
+
 typedef struct  {
 	GnmFilterCondition const *cond;
 	GnmValue		 *val[2];
 	GnmValue		 *alt_val[2];
 	GORegexp		  regexp[2];
-	Sheet			 *target_sheet; /* not necessarilly the src */
+	FilterRows		 *rows;
 } FilterExpr;
 
 static void
@@ -308,28 +367,25 @@ cb_filter_expr (GnmCellIter const *iter, FilterExpr const *fexpr)
 	}
 
  nope:
-	colrow_set_visibility (fexpr->target_sheet, FALSE, FALSE,
-		iter->pp.eval.row, iter->pp.eval.row);
+	filter_rows_hide (fexpr->rows, iter->pp.eval.row);
 	return NULL;
 }
 
 /*****************************************************************************/
 
 static GnmValue *
-cb_filter_non_blanks (GnmCellIter const *iter, Sheet *target_sheet)
+cb_filter_non_blanks (GnmCellIter const *iter, FilterRows *rows)
 {
 	if (gnm_cell_is_blank (iter->cell))
-		colrow_set_visibility (target_sheet, FALSE, FALSE,
-			iter->pp.eval.row, iter->pp.eval.row);
+		filter_rows_hide (rows, iter->pp.eval.row);
 	return NULL;
 }
 
 static GnmValue *
-cb_filter_blanks (GnmCellIter const *iter, Sheet *target_sheet)
+cb_filter_blanks (GnmCellIter const *iter, FilterRows *rows)
 {
 	if (!gnm_cell_is_blank (iter->cell))
-		colrow_set_visibility (target_sheet, FALSE, FALSE,
-			iter->pp.eval.row, iter->pp.eval.row);
+		filter_rows_hide (rows, iter->pp.eval.row);
 	return NULL;
 }
 
@@ -340,13 +396,15 @@ typedef struct {
 	unsigned elements;
 	gboolean find_max;
 	GnmValue const **vals;
-	Sheet	*target_sheet;
+	FilterRows *rows;
 } FilterItems;
 
 static GnmValue *
 cb_filter_find_items (GnmCellIter const *iter, FilterItems *data)
 {
 	GnmValue const *v = iter->cell->value;
+	if (filter_rows_is_hidden (data->rows, iter->pp.eval.row))
+		return NULL;
 	if (data->elements >= data->count) {
 		unsigned j, i = data->elements;
 		GnmValDiff const cond = data->find_max ? IS_GREATER : IS_LESS;
@@ -379,8 +437,7 @@ cb_hide_unwanted_items (GnmCellIter const *iter, FilterItems const *data)
 			if (data->vals[i] == v)
 				return NULL;
 	}
-	colrow_set_visibility (data->target_sheet, FALSE, FALSE,
-		iter->pp.eval.row, iter->pp.eval.row);
+	filter_rows_hide (data->rows, iter->pp.eval.row);
 	return NULL;
 }
 
@@ -389,13 +446,14 @@ cb_hide_unwanted_items (GnmCellIter const *iter, FilterItems const *data)
 typedef struct {
 	gboolean	 initialized, find_max;
 	gnm_float	 low, high;
-	Sheet		*target_sheet;
+	FilterRows	*rows;
 } FilterPercentage;
 
 static GnmValue *
 cb_filter_find_percentage (GnmCellIter const *iter, FilterPercentage *data)
 {
-	if (VALUE_IS_NUMBER (iter->cell->value)) {
+	if (VALUE_IS_NUMBER (iter->cell->value) &&
+	    !filter_rows_is_hidden (data->rows, iter->pp.eval.row)) {
 		gnm_float const v = value_get_as_float (iter->cell->value);
 
 		if (data->initialized) {
@@ -425,8 +483,7 @@ cb_hide_unwanted_percentage (GnmCellIter const *iter,
 				return NULL;
 		}
 	}
-	colrow_set_visibility (data->target_sheet, FALSE, FALSE,
-		iter->pp.eval.row, iter->pp.eval.row);
+	filter_rows_hide (data->rows, iter->pp.eval.row);
 	return NULL;
 }
 /*****************************************************************************/
@@ -441,21 +498,14 @@ gnm_filter_combo_index (GnmFilterCombo *fcombo)
 }
 
 
-/**
- * gnm_filter_combo_apply:
- * @fcombo: #GnmFilterCombo
- * @target_sheet: @Sheet
- *
- **/
-void
-gnm_filter_combo_apply (GnmFilterCombo *fcombo, Sheet *target_sheet)
+static void
+filter_combo_apply_rows (GnmFilterCombo *fcombo, FilterRows *rows)
 {
 	GnmFilter const *filter;
 	GnmFilterCondition const *cond;
 	int col, start_row, end_row;
 	CellIterFlags iter_flags = CELL_ITER_IGNORE_HIDDEN;
-
-	g_return_if_fail (GNM_IS_FILTER_COMBO (fcombo));
+	Sheet *target_sheet = rows->target_sheet;
 
 	filter = fcombo->filter;
 	cond = fcombo->cond;
@@ -479,7 +529,7 @@ gnm_filter_combo_apply (GnmFilterCombo *fcombo, Sheet *target_sheet)
 	if (0x10 >= (cond->op[0] & GNM_FILTER_OP_TYPE_MASK)) {
 		FilterExpr data;
 		data.cond = cond;
-		data.target_sheet = target_sheet;
+		data.rows = rows;
 		filter_expr_init (&data, 0, cond, filter);
 		if (cond->op[1] != GNM_FILTER_UNUSED)
 			filter_expr_init (&data, 1, cond, filter);
@@ -496,12 +546,12 @@ gnm_filter_combo_apply (GnmFilterCombo *fcombo, Sheet *target_sheet)
 		sheet_foreach_cell_in_region (filter->sheet,
 			CELL_ITER_IGNORE_HIDDEN,
 			col, start_row, col, end_row,
-			(CellIterFunc) cb_filter_blanks, target_sheet);
+			(CellIterFunc) cb_filter_blanks, rows);
 	else if (cond->op[0] == GNM_FILTER_OP_NON_BLANKS)
 		sheet_foreach_cell_in_region (filter->sheet,
 			CELL_ITER_IGNORE_HIDDEN,
 			col, start_row, col, end_row,
-			(CellIterFunc) cb_filter_non_blanks, target_sheet);
+			(CellIterFunc) cb_filter_non_blanks, rows);
 	else if (0x30 == (cond->op[0] & GNM_FILTER_OP_TYPE_MASK)) {
 		if (cond->op[0] & GNM_FILTER_OP_PERCENT_MASK) { /* relative */
 			if (cond->op[0] & GNM_FILTER_OP_REL_N_MASK) {
@@ -512,11 +562,11 @@ gnm_filter_combo_apply (GnmFilterCombo *fcombo, Sheet *target_sheet)
 				if (data.count < 1)
 					data.count = 1;
 				data.vals   = g_new (GnmValue const *, data.count);
+				data.rows   = rows;
 				sheet_foreach_cell_in_region (filter->sheet,
 							     CELL_ITER_IGNORE_HIDDEN | CELL_ITER_IGNORE_BLANK,
 							     col, start_row, col, end_row,
 							     (CellIterFunc) cb_filter_find_items, &data);
-				data.target_sheet = target_sheet;
 				sheet_foreach_cell_in_region (filter->sheet,
 							     CELL_ITER_IGNORE_HIDDEN,
 							     col, start_row, col, end_row,
@@ -528,6 +578,7 @@ gnm_filter_combo_apply (GnmFilterCombo *fcombo, Sheet *target_sheet)
 
 				data.find_max = (cond->op[0] & 0x1) ? FALSE : TRUE;
 				data.initialized = FALSE;
+				data.rows = rows;
 				sheet_foreach_cell_in_region (filter->sheet,
 							     CELL_ITER_IGNORE_HIDDEN | CELL_ITER_IGNORE_BLANK,
 							     col, start_row, col, end_row,
@@ -535,7 +586,6 @@ gnm_filter_combo_apply (GnmFilterCombo *fcombo, Sheet *target_sheet)
 				offset = (data.high - data.low) * cond->count / 100.;
 				data.high -= offset;
 				data.low  += offset;
-				data.target_sheet = target_sheet;
 				sheet_foreach_cell_in_region (filter->sheet,
 							     CELL_ITER_IGNORE_HIDDEN,
 							     col, start_row, col, end_row,
@@ -547,12 +597,12 @@ gnm_filter_combo_apply (GnmFilterCombo *fcombo, Sheet *target_sheet)
 			data.elements    = 0;
 			data.count  = cond->count;
 			data.vals   = g_new (GnmValue const *, data.count);
+			data.rows   = rows;
 
 			sheet_foreach_cell_in_region (filter->sheet,
 				CELL_ITER_IGNORE_HIDDEN | CELL_ITER_IGNORE_BLANK,
 				col, start_row, col, end_row,
 				(CellIterFunc) cb_filter_find_items, &data);
-			data.target_sheet = target_sheet;
 			sheet_foreach_cell_in_region (filter->sheet,
 				CELL_ITER_IGNORE_HIDDEN,
 				col, start_row, col, end_row,
@@ -563,6 +613,30 @@ gnm_filter_combo_apply (GnmFilterCombo *fcombo, Sheet *target_sheet)
 		g_warning ("Invalid operator %d", cond->op[0]);
 }
 
+/**
+ * gnm_filter_combo_apply:
+ * @fcombo: #GnmFilterCombo
+ * @target_sheet: @Sheet
+ *
+ **/
+void
+gnm_filter_combo_apply (GnmFilterCombo *fcombo, Sheet *target_sheet)
+{
+	GnmFilter const *filter;
+	FilterRows rows;
+
+	g_return_if_fail (GNM_IS_FILTER_COMBO (fcombo));
+
+	filter = fcombo->filter;
+	if (filter->r.start.row >= filter->r.end.row)
+		return;
+
+	filter_rows_init (&rows, target_sheet,
+			  filter->r.start.row + 1, filter->r.end.row);
+	filter_combo_apply_rows (fcombo, &rows);
+	filter_rows_commit (&rows);
+}
+
 enum {
 	COND_CHANGED,
 	LAST_SIGNAL
@@ -841,12 +915,19 @@ void
 gnm_filter_reapply (GnmFilter *filter)
 {
 	unsigned i;
+	FilterRows rows;
+
+	if (filter->r.start.row >= filter->r.end.row)
+		return;
 
 	colrow_set_visibility (filter->sheet, FALSE, TRUE,
 			       filter->r.start.row + 1, filter->r.end.row);
+	filter_rows_init (&rows, filter->sheet,
+			  filter->r.start.row + 1, filter->r.end.row);
 	for (i = 0 ; i < filter->fields->len ; i++)
-		gnm_filter_combo_apply (g_ptr_array_index (filter->fields, i),
-					filter->sheet);
+		filter_combo_apply_rows (g_ptr_array_index (filter->fields, i),
+					 &rows);
+	filter_rows_commit (&rows);
 }
 
 static void
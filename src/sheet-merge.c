@@ -45,6 +45,106 @@ range_row_cmp (GnmRange const *a, GnmRange const *b)
 	return tmp;
 }
 
+/*
+ * Merged regions never overlap each other, so a block of rows holds few
+ * of them.  Each region is listed in every block of MERGE_BUCKET_SIZE rows
+ * that it touches, which makes position and overlap queries look at a
+ * handful of regions rather than all of them.
+ *
+ * Regions touching more than MERGE_TALL_BUCKETS blocks would crowd many
+ * blocks instead, so they are kept in a single list that every query
+ * checks.
+ */
+#define MERGE_BUCKET_BITS 6
+#define MERGE_BUCKET_SIZE (1 << MERGE_BUCKET_BITS)
+#define MERGE_BUCKET_OF_ROW(row) ((row) >> MERGE_BUCKET_BITS)
+#define MERGE_TALL_BUCKETS 4
+
+static gboolean
+merge_is_tall (GnmRange const *r)
+{
+	return MERGE_BUCKET_OF_ROW (r->end.row) -
+		MERGE_BUCKET_OF_ROW (r->start.row) >= MERGE_TALL_BUCKETS;
+}
+
+static GPtrArray *
+merge_bucket (Sheet const *sheet, int b)
+{
+	GPtrArray *buckets = sheet->priv->merged_buckets;
+	return (buckets && b < (int)buckets->len)
+		? g_ptr_array_index (buckets, b)
+		: NULL;
+}
+
+static void
+merge_index_add (Sheet *sheet, GnmRange const *r)
+{
+	GPtrArray *buckets = sheet->priv->merged_buckets;
+	int b, last = MERGE_BUCKET_OF_ROW (r->end.row);
+
+	if (merge_is_tall (r)) {
+		if (sheet->priv->merged_tall == NULL)
+			sheet->priv->merged_tall = g_ptr_array_new ();
+		g_ptr_array_add (sheet->priv->merged_tall, (gpointer)r);
+		return;
+	}
+
+	if (buckets == NULL)
+		buckets = sheet->priv->merged_buckets = g_ptr_array_new ();
+	if ((int)buckets->len <= last)
+		g_ptr_array_set_size (buckets, last + 1);
+
+	for (b = MERGE_BUCKET_OF_ROW (r->start.row); b <= last; b++) {
+		GPtrArray *bucket = g_ptr_array_index (buckets, b);
+		if (bucket == NULL)
+			bucket = g_ptr_array_index (buckets, b) =
+				g_ptr_array_new ();
+		g_ptr_array_add (bucket, (gpointer)r);
+	}
+}
+
+static void
+merge_index_remove (Sheet *sheet, GnmRange const *r)
+{
+	int b, last = MERGE_BUCKET_OF_ROW (r->end.row);
+
+	if (merge_is_tall (r)) {
+		if (sheet->priv->merged_tall)
+			g_ptr_array_remove_fast (sheet->priv->merged_tall,
+						 (gpointer)r);
+		return;
+	}
+
+	for (b = MERGE_BUCKET_OF_ROW (r->start.row); b <= last; b++) {
+		GPtrArray *bucket = merge_bucket (sheet, b);
+		if (bucket)
+			g_ptr_array_remove_fast (bucket, (gpointer)r);
+	}
+}
+
+void
+gnm_sheet_merge_index_free (Sheet *sheet)
+{
+	GPtrArray *buckets = sheet->priv->merged_buckets;
+	unsigned b;
+
+	if (sheet->priv->merged_tall) {
+		g_ptr_array_free (sheet->priv->merged_tall, TRUE);
+		sheet->priv->merged_tall = NULL;
+	}
+
+	if (buckets == NULL)
+		return;
+
+	for (b = 0; b < buckets->len; b++) {
+		GPtrArray *bucket = g_ptr_array_index (buckets, b);
+		if (bucket)
+			g_ptr_array_free (bucket, TRUE);
+	}
+	g_ptr_array_free (buckets, TRUE);
+	sheet->priv->merged_buckets = NULL;
+}
+
 /**
  * gnm_sheet_merge_add:
  * @sheet: the sheet which will contain the region
@@ -123,6 +223,7 @@ gnm_sheet_merge_add (Sheet *sheet, GnmRange const *r, gboolean clear,
 	/* Store in order from bottom to top then LEFT TO RIGHT (by start coord) */
 	sheet->list_merged = g_slist_insert_sorted (sheet->list_merged, r_copy,
 						    (GCompareFunc)range_row_cmp);
+	merge_index_add (sheet, r_copy);
 
 	cell = sheet_cell_get (sheet, r2.start.col, r2.start.row);
 	if (cell != NULL) {
@@ -181,6 +282,7 @@ gnm_sheet_merge_remove (Sheet *sheet, GnmRange const *r)
 
 	g_hash_table_remove (sheet->hash_merged, &r_copy->start);
 	sheet->list_merged = g_slist_remove (sheet->list_merged, r_copy);
+	merge_index_remove (sheet, r_copy);
 
 	cell = sheet_cell_get (sheet, r->start.col, r->start.row);
 	if (cell != NULL)
@@ -204,22 +306,63 @@ gnm_sheet_merge_remove (Sheet *sheet, GnmRange const *r)
  * regions that overlap the target region.
  * The list is ordered from top to bottom and RIGHT TO LEFT (by start coord).
  */
+static gint
+range_overlap_order (GnmRange const *a, GnmRange const *b)
+{
+	return range_row_cmp (b, a);
+}
+
 GSList *
 gnm_sheet_merge_get_overlap (Sheet const *sheet, GnmRange const *range)
 {
-	GSList *ptr, *res = NULL;
+	GPtrArray *tall;
+	GSList *res = NULL;
+	int b, first, last;
+	unsigned ui;
 
 	g_return_val_if_fail (IS_SHEET (sheet), NULL);
 	g_return_val_if_fail (range != NULL, NULL);
 
-	for (ptr = sheet->list_merged ; ptr != NULL ; ptr = ptr->next) {
-		GnmRange * const test = ptr->data;
-
+	tall = sheet->priv->merged_tall;
+	for (ui = 0; tall && ui < tall->len; ui++) {
+		GnmRange *test = g_ptr_array_index (tall, ui);
 		if (range_overlap (range, test))
 			res = g_slist_prepend (res, test);
 	}
 
-	return res;
+	if (sheet->priv->merged_buckets == NULL)
+		return g_slist_sort (res, (GCompareFunc)range_overlap_order);
+
+	first = MERGE_BUCKET_OF_ROW (MAX (range->start.row, 0));
+	last = MIN (MERGE_BUCKET_OF_ROW (range->end.row),
+		    (int)sheet->priv->merged_buckets->len - 1);
+	for (b = first; b <= last; b++) {
+		GPtrArray *bucket = merge_bucket (sheet, b);
+
+		for (ui = 0; bucket && ui < bucket->len; ui++) {
+			GnmRange *test = g_ptr_array_index (bucket, ui);
+
+			/* Report each region from the first block we share.  */
+			if (range_overlap (range, test) &&
+			    MERGE_BUCKET_OF_ROW (MAX (range->start.row, test->start.row)) == b)
+				res = g_slist_prepend (res, test);
+		}
+	}
+
+	return g_slist_sort (res, (GCompareFunc)range_overlap_order);
+}
+
+static GnmRange const *
+merge_find_pos (GPtrArray const *ranges, GnmCellPos const *pos)
+{
+	unsigned ui;
+
+	for (ui = 0; ranges && ui < ranges->len; ui++) {
+		GnmRange const * const range = g_ptr_array_index (ranges, ui);
+		if (range_contains (range, pos->col, pos->row))
+			return range;
+	}
+	return NULL;
 }
 
 /**
@@ -233,17 +376,40 @@ gnm_sheet_merge_get_overlap (Sheet const *sheet, GnmRange const *range)
 GnmRange const *
 gnm_sheet_merge_contains_pos (Sheet const *sheet, GnmCellPos const *pos)
 {
-	GSList *ptr;
+	GnmRange const *res;
 
 	g_return_val_if_fail (IS_SHEET (sheet), NULL);
 	g_return_val_if_fail (pos != NULL, NULL);
 
-	for (ptr = sheet->list_merged ; ptr != NULL ; ptr = ptr->next) {
-		GnmRange const * const range = ptr->data;
-		if (range_contains (range, pos->col, pos->row))
-			return range;
+	res = merge_find_pos (merge_bucket (sheet, MERGE_BUCKET_OF_ROW (pos->row)),
+			      pos);
+	if (res == NULL)
+		res = merge_find_pos (sheet->priv->merged_tall, pos);
+	return res;
+}
+
+static void
+merge_find_adjacent (GPtrArray const *ranges, GnmCellPos const *pos,
+		     GnmRange const **left, GnmRange const **right)
+{
+	unsigned ui;
+
+	for (ui = 0; ranges && ui < ranges->len; ui++) {
+		GnmRange const * const test = g_ptr_array_index (ranges, ui);
+		if (test->start.row <= pos->row && pos->row <= test->end.row) {
+			int const diff = test->end.col - pos->col;
+
+			g_return_if_fail (diff != 0);
+
+			if (diff < 0) {
+				if (*left == NULL || (*left)->end.col < test->end.col)
+					*left = test;
+			} else {
+				if (*right == NULL || (*right)->start.col > test->start.col)
+					*right = test;
+			}
+		}
 	}
-	return NULL;
 }
 
 /**
@@ -259,28 +425,13 @@ void
 gnm_sheet_merge_get_adjacent (Sheet const *sheet, GnmCellPos const *pos,
 			      GnmRange const **left, GnmRange const **right)
 {
-	GSList *ptr;
-
 	g_return_if_fail (IS_SHEET (sheet));
 	g_return_if_fail (pos != NULL);
 
 	*left = *right = NULL;
-	for (ptr = sheet->list_merged ; ptr != NULL ; ptr = ptr->next) {
-		GnmRange const * const test = ptr->data;
-		if (test->start.row <= pos->row && pos->row <= test->end.row) {
-			int const diff = test->end.col - pos->col;
-
-			g_return_if_fail (diff != 0);
-
-			if (diff < 0) {
-				if (*left == NULL || (*left)->end.col < test->end.col)
-					*left = test;
-			} else {
-				if (*right == NULL || (*right)->start.col > test->start.col)
-					*right = test;
-			}
-		}
-	}
+	merge_find_adjacent (merge_bucket (sheet, MERGE_BUCKET_OF_ROW (pos->row)),
+			     pos, left, right);
+	merge_find_adjacent (sheet->priv->merged_tall, pos, left, right);
 }
 
 /**
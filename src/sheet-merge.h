@@ -24,6 +24,9 @@ void	     gnm_sheet_merge_get_adjacent	(Sheet const *sheet,
 						 GnmRange const **left,
 						 GnmRange const **right);
 
+/* for internal use only */
+void	     gnm_sheet_merge_index_free		(Sheet *sheet);
+
 G_END_DECLS
 
 #endif /* _GNM_SHEET_MERGE_H_ */
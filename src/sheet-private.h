@@ -18,6 +18,20 @@ struct _SheetPrivate {
 	GnmCellPos	 reposition_objects;
 	unsigned char	 filters_changed;
 	unsigned char	 objects_changed;
+
+	/*
+	 * Rows whose span_generation differs from this are stale.  Bumping
+	 * it invalidates the spans of every row without touching them.
+	 */
+	unsigned	 span_generation;
+
+	/*
+	 * Merged regions by blocks of rows.  Element i is a GPtrArray of the
+	 * regions overlapping block i, or NULL.  Regions spanning many blocks
+	 * are in merged_tall instead.  See sheet-merge.c
+	 */
+	GPtrArray	*merged_buckets;
+	GPtrArray	*merged_tall;
 };
 
 /* for internal use only */
@@ -122,6 +122,25 @@ sh_all_styles (GnmStyleHash *h)
 	return res;
 }
 
+static void
+sh_dump_stats (GnmStyleHash *h, char const *name)
+{
+	GHashTableIter iter;
+	gpointer value;
+	guint n_styles = 0, n_chains = 0, longest = 0;
+
+	g_hash_table_iter_init (&iter, h);
+	while (g_hash_table_iter_next (&iter, NULL, &value)) {
+		guint len = g_slist_length (value);
+		n_styles += len;
+		n_chains++;
+		longest = MAX (longest, len);
+	}
+
+	g_printerr ("Sheet %s: %u styles in %u hash chains (longest %u)\n",
+		    name, n_styles, n_chains, longest);
+}
+
 static GnmStyleHash *
 sh_create (void)
 {
@@ -160,6 +179,7 @@ static gboolean debug_style_optimize;
 static gboolean debug_style_optimize_verbose;
 static gboolean debug_style_split;
 static gboolean debug_style_apply;
+static gboolean debug_style_stats;
 
 typedef struct {
 	GnmSheetSize const *ss;
@@ -706,6 +726,7 @@ sheet_style_init (Sheet *sheet)
 		gnm_debug_flag ("style-optimize");
 	debug_style_split = gnm_debug_flag ("style-split");
 	debug_style_apply = gnm_debug_flag ("style-apply");
+	debug_style_stats = gnm_debug_flag ("style-stats");
 
 	sheet_style_init_size (sheet, cols, rows);
 }
@@ -3279,6 +3300,10 @@ sheet_style_optimize (Sheet *sheet)
 	if (debug_style_optimize)
 		g_printerr ("Optimizing %s...done\n", sheet->name_unquoted);
 
+	if (debug_style_stats)
+		sh_dump_stats (sheet->style_data->style_hash,
+			       sheet->name_unquoted);
+
 	if (verify) {
 		GSList *post = sample_styles (sheet);
 		verify_styles (pre, post);
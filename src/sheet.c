@@ -1110,7 +1110,7 @@ gnm_sheet_class_init (GObjectClass *gobject_class)
 		g_param_spec_int ("rows",
 				  P_("Rows"),
 				  P_("Rows number in the sheet"),
-				  0, GNM_MAX_ROWS, GNM_DEFAULT_ROWS,
+				  0, GNM_HUGE_MAX_ROWS, GNM_DEFAULT_ROWS,
 				  GSF_PARAM_STATIC | G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
 
 	signals[DETACHED_FROM_WORKBOOK] = g_signal_new
@@ -1169,6 +1169,30 @@ powerof_2 (int i)
 	return i > 0 && (i & (i - 1)) == 0;
 }
 
+/**
+ * gnm_sheet_max_rows_limit:
+ *
+ * Returns: the largest number of rows a sheet may have.  This is
+ * GNM_MAX_ROWS unless huge sheets have been enabled with
+ * GNM_DEBUG=huge-sheets, in which case it is GNM_HUGE_MAX_ROWS.
+ *
+ * Large sheets cost little beyond their contents: row segments and style
+ * tiles are allocated as needed and dependency buckets grow
+ * logarithmically with the number of rows.
+ */
+int
+gnm_sheet_max_rows_limit (void)
+{
+	static int limit = 0;
+
+	if (limit == 0)
+		limit = gnm_debug_flag ("huge-sheets")
+			? GNM_HUGE_MAX_ROWS
+			: GNM_MAX_ROWS;
+
+	return limit;
+}
+
 gboolean
 gnm_sheet_valid_size (int cols, int rows)
 {
@@ -1176,7 +1200,7 @@ gnm_sheet_valid_size (int cols, int rows)
 		cols <= GNM_MAX_COLS &&
 		powerof_2 (cols) &&
 		rows >= GNM_MIN_ROWS &&
-		rows <= GNM_MAX_ROWS &&
+		rows <= gnm_sheet_max_rows_limit () &&
 		powerof_2 (rows)
 #if 0
        	&& 0x80000000u / (unsigned)(cols / 2) >= (unsigned)rows
@@ -1203,7 +1227,7 @@ gnm_sheet_suggest_size (int *cols, int *rows)
 	while (c < *cols && c < GNM_MAX_COLS)
 		c *= 2;
 
-	while (r < *rows && r < GNM_MAX_ROWS)
+	while (r < *rows && r < gnm_sheet_max_rows_limit ())
 		r *= 2;
 
 	while (!gnm_sheet_valid_size (c, r)) {
@@ -2339,7 +2363,7 @@ cb_sheet_get_extent (G_GNUC_UNUSED gpointer ignored, gpointer value, gpointer da
 		CellSpanInfo const *span;
 		if (ri == NULL)
 			ri = sheet_row_get (sheet, cell->pos.row);
-		if (ri->needs_respan)
+		if (row_needs_respan (ri, sheet))
 			row_calc_spans (ri, cell->pos.row, sheet);
 		span = row_span_get (ri, cell->pos.col);
 		if (NULL != span) {
@@ -3199,7 +3223,7 @@ sheet_range_bounding_box (Sheet const *sheet, GnmRange *bound)
 		if (ri != NULL) {
 			CellSpanInfo const * span0;
 
-			if (ri->needs_respan)
+			if (row_needs_respan (ri, sheet))
 				row_calc_spans ((ColRowInfo *)ri, row, sheet);
 
 			span0 = row_span_get (ri, r.start.col);
@@ -4866,6 +4890,7 @@ sheet_destroy_contents (Sheet *sheet)
 	g_hash_table_destroy (sheet->hash_merged);
 	sheet->hash_merged = NULL;
 
+	gnm_sheet_merge_index_free (sheet);
 	g_slist_free_full (sheet->list_merged, g_free);
 	sheet->list_merged = NULL;
 
@@ -5279,7 +5304,7 @@ cb_undo_insdel_free (ColRowInsDelData *data)
 
 static gboolean
 sheet_insdel_colrow (Sheet *sheet, int pos, int count,
-		     GOUndo **pundo, GOCmdContext *cc,
+		     GOUndo **pundo, gint64 *undo_size, GOCmdContext *cc,
 		     gboolean is_cols, gboolean is_insert,
 		     const char *description,
 		     ColRowInsDelFunc opposite)
@@ -5295,6 +5320,7 @@ sheet_insdel_colrow (Sheet *sheet, int pos, int count,
 	GnmExprRelocateInfo reloc_info;
 	GSList *l;
 	gboolean sticky_end = TRUE;
+	gint64 size = 0;
 
 	g_return_val_if_fail (IS_SHEET (sheet), TRUE);
 	g_return_val_if_fail (count > 0, TRUE);
@@ -5306,6 +5332,7 @@ sheet_insdel_colrow (Sheet *sheet, int pos, int count,
 	 * zone.
 	 */
 	if (pundo) *pundo = NULL;
+	if (undo_size) *undo_size = 0;
 
 	last_pos = colrow_max (is_cols, sheet) - 1;
 	max_used_pos = is_cols ? sheet->cols.max_used : sheet->rows.max_used;
@@ -5350,7 +5377,9 @@ sheet_insdel_colrow (Sheet *sheet, int pos, int count,
 
 	/* 1. Delete all columns/rows in the kill zone */
 	if (pundo) {
-		combine_undo (pundo, clipboard_copy_range_undo (sheet, &kill_zone));
+		combine_undo (pundo, clipboard_copy_range_undo_size
+			      (sheet, &kill_zone, &size));
+		if (undo_size) *undo_size += size;
 		states = colrow_get_states (sheet, is_cols, kill_start, kill_end);
 	}
 	for (i = MIN (max_used_pos, kill_end); i >= kill_start; --i)
@@ -5376,14 +5405,16 @@ sheet_insdel_colrow (Sheet *sheet, int pos, int count,
 		/* Force invalidation: */
 		reloc_info.col_offset = is_cols ? last_pos + 1 : 0;
 		reloc_info.row_offset = is_cols ? 0 : last_pos + 1;
-		combine_undo (pundo, dependents_relocate (&reloc_info));
+		combine_undo (pundo, dependents_relocate_size (&reloc_info, &size));
+		if (undo_size) *undo_size += size;
 	}
 
 	/* 4. Fix references to the cells which are moving */
 	reloc_info.origin = is_insert ? change_zone : move_zone;
 	reloc_info.col_offset = is_cols ? scount : 0;
 	reloc_info.row_offset = is_cols ? 0 : scount;
-	combine_undo (pundo, dependents_relocate (&reloc_info));
+	combine_undo (pundo, dependents_relocate_size (&reloc_info, &size));
+	if (undo_size) *undo_size += size;
 
 	/* 5. Move the cells */
 	sheet_cells_deps_move (&reloc_info);
@@ -5463,6 +5494,37 @@ sheet_insdel_colrow (Sheet *sheet, int pos, int count,
 	return FALSE;
 }
 
+/**
+ * sheet_colrow_insdel:
+ * @sheet: The sheet
+ * @is_cols: %TRUE for columns, %FALSE for rows
+ * @is_insert: %TRUE to insert, %FALSE to delete
+ * @pos: At which position we want to insert or start deleting
+ * @count: The number of columns or rows
+ * @pundo: (out): (transfer full): (allow-none): undo closure
+ * @undo_size: (out) (optional): the size, in undo units, of the contents
+ * saved in @pundo
+ * @cc: The command context
+ */
+gboolean
+sheet_colrow_insdel (Sheet *sheet, gboolean is_cols, gboolean is_insert,
+		     int pos, int count,
+		     GOUndo **pundo, gint64 *undo_size, GOCmdContext *cc)
+{
+	if (is_insert)
+		return sheet_insdel_colrow (sheet, pos, count,
+					    pundo, undo_size, cc,
+					    is_cols, TRUE,
+					    is_cols ? _("Insert Columns") : _("Insert Rows"),
+					    is_cols ? sheet_delete_cols : sheet_delete_rows);
+	else
+		return sheet_insdel_colrow (sheet, pos, count,
+					    pundo, undo_size, cc,
+					    is_cols, FALSE,
+					    is_cols ? _("Delete Columns") : _("Delete Rows"),
+					    is_cols ? sheet_insert_cols : sheet_insert_rows);
+}
+
 /**
  * sheet_insert_cols:
  * @sheet: #Sheet
@@ -5475,10 +5537,8 @@ gboolean
 sheet_insert_cols (Sheet *sheet, int col, int count,
 		   GOUndo **pundo, GOCmdContext *cc)
 {
-	return sheet_insdel_colrow (sheet, col, count, pundo, cc,
-				    TRUE, TRUE,
-				    _("Insert Columns"),
-				    sheet_delete_cols);
+	return sheet_colrow_insdel (sheet, TRUE, TRUE, col, count,
+				    pundo, NULL, cc);
 }
 
 /**
@@ -5493,10 +5553,8 @@ gboolean
 sheet_delete_cols (Sheet *sheet, int col, int count,
 		   GOUndo **pundo, GOCmdContext *cc)
 {
-	return sheet_insdel_colrow (sheet, col, count, pundo, cc,
-				    TRUE, FALSE,
-				    _("Delete Columns"),
-				    sheet_insert_cols);
+	return sheet_colrow_insdel (sheet, TRUE, FALSE, col, count,
+				    pundo, NULL, cc);
 }
 
 /**
@@ -5511,10 +5569,8 @@ gboolean
 sheet_insert_rows (Sheet *sheet, int row, int count,
 		   GOUndo **pundo, GOCmdContext *cc)
 {
-	return sheet_insdel_colrow (sheet, row, count, pundo, cc,
-				    FALSE, TRUE,
-				    _("Insert Rows"),
-				    sheet_delete_rows);
+	return sheet_colrow_insdel (sheet, FALSE, TRUE, row, count,
+				    pundo, NULL, cc);
 }
 
 /**
@@ -5529,10 +5585,8 @@ gboolean
 sheet_delete_rows (Sheet *sheet, int row, int count,
 		   GOUndo **pundo, GOCmdContext *cc)
 {
-	return sheet_insdel_colrow (sheet, row, count, pundo, cc,
-				    FALSE, FALSE,
-				    _("Delete Rows"),
-				    sheet_insert_rows);
+	return sheet_colrow_insdel (sheet, FALSE, FALSE, row, count,
+				    pundo, NULL, cc);
 }
 
 /*
@@ -6238,11 +6292,18 @@ sheet_dup_names (Sheet const *src, Sheet *dst)
 	g_slist_free (names);
 }
 
+typedef struct {
+	Sheet *dst;
+	/* Relocated expressions by source expression.  */
+	GHashTable *texprs;
+} SheetDupCells;
+
 static void
-cb_sheet_cell_copy (G_GNUC_UNUSED gpointer unused, gpointer key, gpointer new_sheet_param)
+cb_sheet_cell_copy (G_GNUC_UNUSED gpointer unused, gpointer key, gpointer user)
 {
 	GnmCell const *cell = key;
-	Sheet *dst = new_sheet_param;
+	SheetDupCells *closure = user;
+	Sheet *dst = closure->dst;
 	Sheet *src;
 	GnmExprTop const *texpr;
 
@@ -6270,9 +6331,20 @@ cb_sheet_cell_copy (G_GNUC_UNUSED gpointer unused, gpointer key, gpointer new_sh
 	} else {
 		GnmCell *new_cell = sheet_cell_create (dst, cell->pos.col, cell->pos.row);
 		if (gnm_cell_has_expr (cell)) {
-			texpr = gnm_expr_top_relocate_sheet (texpr, src, dst);
+			/*
+			 * The relocation does not depend on the cell's
+			 * position, so cells sharing an expression keep
+			 * sharing it and it is relocated only once.
+			 */
+			GnmExprTop const *src_texpr = texpr;
+			texpr = g_hash_table_lookup (closure->texprs, src_texpr);
+			if (texpr == NULL) {
+				texpr = gnm_expr_top_relocate_sheet (src_texpr, src, dst);
+				g_hash_table_insert (closure->texprs,
+						     (gpointer)src_texpr,
+						     (gpointer)texpr);
+			}
 			gnm_cell_set_expr_and_value (new_cell, texpr, value_new_empty (), TRUE);
-			gnm_expr_top_unref (texpr);
 		} else
 			gnm_cell_set_value (new_cell, value_dup (cell->value));
 	}
@@ -6281,7 +6353,14 @@ cb_sheet_cell_copy (G_GNUC_UNUSED gpointer unused, gpointer key, gpointer new_sh
 static void
 sheet_dup_cells (Sheet const *src, Sheet *dst)
 {
-	sheet_cell_foreach (src, &cb_sheet_cell_copy, dst);
+	SheetDupCells closure;
+
+	closure.dst = dst;
+	closure.texprs = g_hash_table_new_full
+		(g_direct_hash, g_direct_equal,
+		 NULL, (GDestroyNotify)gnm_expr_top_unref);
+	sheet_cell_foreach (src, &cb_sheet_cell_copy, &closure);
+	g_hash_table_destroy (closure.texprs);
 	sheet_region_queue_recalc (dst, NULL);
 }
 
@@ -6425,10 +6504,25 @@ cb_queue_respan (GnmColRowIter const *iter, void *user_data)
  *
  * queues a span generation for the selected rows.
  * the caller is responsible for queuing a redraw
+ *
+ * Queuing the whole sheet is O(1): it merely bumps the sheet's span
+ * generation and rows get respanned when they are next drawn or printed.
  **/
 void
 sheet_queue_respan (Sheet const *sheet, int start_row, int end_row)
 {
+	if (start_row <= 0 && end_row >= gnm_sheet_get_last_row (sheet)) {
+		SheetPrivate *p = sheet->priv;
+		p->span_generation =
+			(p->span_generation + 1) & COLROW_SPAN_GENERATION_MASK;
+		/*
+		 * On wrap-around a row stamped long ago could look current,
+		 * so flag every row the old-fashioned way.
+		 */
+		if (p->span_generation != 0)
+			return;
+	}
+
 	sheet_colrow_foreach (sheet, FALSE, start_row, end_row,
 			      cb_queue_respan, NULL);
 }
@@ -137,6 +137,7 @@ Sheet    *sheet_dup		 (Sheet const *source_sheet);
 void      sheet_destroy_contents (Sheet *sheet);
 
 gboolean  gnm_sheet_valid_size   (int cols, int rows);
+int       gnm_sheet_max_rows_limit (void);
 void      gnm_sheet_suggest_size (int *cols, int *rows);
 
 GOUndo   *gnm_sheet_resize       (Sheet *sheet, int cols, int rows,
@@ -373,6 +374,10 @@ gboolean     sheet_selection_is_allowed (Sheet const *sheet, GnmCellPos const *p
 
 GnmConventions const *sheet_get_conventions (Sheet const *sheet);
 
+gboolean  sheet_colrow_insdel (Sheet *sheet, gboolean is_cols,
+			       gboolean is_insert, int pos, int count,
+			       GOUndo **pundo, gint64 *undo_size,
+			       GOCmdContext *cc);
 gboolean  sheet_insert_cols (Sheet *sheet, int col, int count,
 			     GOUndo **pundo, GOCmdContext *cc);
 gboolean  sheet_delete_cols (Sheet *sheet, int col, int count,
@@ -20,11 +20,35 @@
 #include <ranges.h>
 #include <goffice/goffice.h>
 #include <stdlib.h>
+#include <string.h>
+
+/*
+ * Sort keys are extracted once per cell before sorting.  Numbers and
+ * strings, the common case, then compare without touching the sheet:
+ * strings through collation keys computed once.  Anything else compares
+ * through the values themselves.
+ */
+typedef enum {
+	SORT_KEY_OTHER,
+	SORT_KEY_FLOAT,
+	SORT_KEY_STRING
+} SortKeyKind;
 
 typedef struct {
-	int index;
-	GnmSortData *data;
-} SortDataPerm;
+	SortKeyKind kind;
+	union {
+		gnm_float f;
+		char const *s;	/* Collation key */
+	} u;
+	GnmValue const *v;
+} SortKey;
+
+typedef struct {
+	GnmSortData const *data;
+	SortKey *keys;		/* num_clause keys per row or column */
+	gboolean default_locale;
+	GStringChunk *pool;	/* Collation keys for a non-default locale */
+} SortKeys;
 
 
 /* Data stuff */
@@ -48,23 +72,13 @@ gnm_sort_data_length (GnmSortData const *data)
 
 /* The routines to do the sorting */
 static int
-sort_compare_cells (GnmCell const *ca, GnmCell const *cb,
-		    GnmSortClause *clause, gboolean default_locale)
+sort_compare_values (GnmValue const *a, GnmValue const *b,
+		     GnmSortClause const *clause, gboolean default_locale)
 {
-	GnmValue *a, *b;
 	GnmValueType ta, tb;
 	GnmValDiff comp = IS_EQUAL;
 	int ans = 0;
 
-	if (!ca)
-		a = NULL;
-	else
-		a = ca->value;
-	if (!cb)
-		b = NULL;
-	else
-		b = cb->value;
-
 	ta = VALUE_IS_EMPTY (a) ? VALUE_EMPTY : a->v_any.type;
 	tb = VALUE_IS_EMPTY (b) ? VALUE_EMPTY : b->v_any.type;
 
@@ -91,76 +105,177 @@ sort_compare_cells (GnmCell const *ca, GnmCell const *cb,
 }
 
 static int
-sort_compare_sets (GnmSortData const *data, int indexa, int indexb,
-		   gboolean default_locale)
+sort_compare_keys (SortKey const *ka, SortKey const *kb,
+		   GnmSortClause const *clause, gboolean default_locale)
 {
-	GnmCell *ca, *cb;
-	int clause = 0;
-
-	while (clause < data->num_clause) {
-		int result = 0;
-		int offset = data->clauses[clause].offset;
-
-		if (data->top) {
-			ca = sheet_cell_get (data->sheet,
-					     data->range->start.col + offset,
-					     data->range->start.row + indexa);
-			cb = sheet_cell_get (data->sheet,
-					     data->range->start.col + offset,
-					     data->range->start.row + indexb);
-		} else {
-			ca = sheet_cell_get (data->sheet,
-					     data->range->start.col + indexa,
-					     data->range->start.row + offset);
-			cb = sheet_cell_get (data->sheet,
-					     data->range->start.col + indexb,
-					     data->range->start.row + offset);
-		}
+	int c;
+
+	if (ka->kind == SORT_KEY_FLOAT && kb->kind == SORT_KEY_FLOAT)
+		c = (ka->u.f < kb->u.f) ? -1 : (ka->u.f > kb->u.f);
+	else if (ka->kind == SORT_KEY_STRING && kb->kind == SORT_KEY_STRING) {
+		c = strcmp (ka->u.s, kb->u.s);
+		c = (c < 0) ? -1 : (c > 0);
+	} else
+		return sort_compare_values (ka->v, kb->v, clause,
+					    default_locale);
+
+	/* Yes, "asc" means descending.  */
+	return clause->asc ? -c : c;
+}
 
-		result = sort_compare_cells (ca, cb, &(data->clauses[clause]),
-					     default_locale);
-		if (result) {
+static int
+sort_compare_sets (SortKeys const *sk, int indexa, int indexb)
+{
+	GnmSortData const *data = sk->data;
+	SortKey const *ka = sk->keys + (size_t)indexa * data->num_clause;
+	SortKey const *kb = sk->keys + (size_t)indexb * data->num_clause;
+	int clause;
+
+	for (clause = 0; clause < data->num_clause; clause++) {
+		int result = sort_compare_keys (ka + clause, kb + clause,
+						data->clauses + clause,
+						sk->default_locale);
+		if (result)
 			return result;
-		}
-		clause++;
 	}
 
-	/* Items are identical; make sort stable by using the indices.  */
-	return indexa - indexb;
+	return 0;
 }
 
-static int
-sort_qsort_compare (void const *_a, void const *_b)
+static void
+sort_keys_init (SortKeys *sk, GnmSortData const *data, char const *real,
+		int length, gboolean default_locale)
 {
-	SortDataPerm const *a = (SortDataPerm const *)_a;
-	SortDataPerm const *b = (SortDataPerm const *)_b;
+	int i, clause;
 
-	return sort_compare_sets (a->data, a->index, b->index, TRUE);
+	sk->data = data;
+	sk->default_locale = default_locale;
+	sk->pool = default_locale ? NULL : g_string_chunk_new (64 * 1024);
+	sk->keys = g_new0 (SortKey, (size_t)length * data->num_clause);
+
+	for (i = 0; i < length; i++) {
+		if (!real[i])
+			continue;
+
+		for (clause = 0; clause < data->num_clause; clause++) {
+			GnmSortClause const *c = data->clauses + clause;
+			SortKey *k = sk->keys + (size_t)i * data->num_clause + clause;
+			int offset = c->offset;
+			GnmCell const *cell = data->top
+				? sheet_cell_get (data->sheet,
+						  data->range->start.col + offset,
+						  data->range->start.row + i)
+				: sheet_cell_get (data->sheet,
+						  data->range->start.col + i,
+						  data->range->start.row + offset);
+			GnmValue const *v = cell ? cell->value : NULL;
+
+			k->v = v;
+			if (v == NULL)
+				k->kind = SORT_KEY_OTHER;
+			else if (VALUE_IS_FLOAT (v)) {
+				k->kind = SORT_KEY_FLOAT;
+				k->u.f = value_get_as_float (v);
+			} else if (VALUE_IS_STRING (v)) {
+				GOString const *gs = v->v_str.val;
+
+				k->kind = SORT_KEY_STRING;
+				if (default_locale)
+					/* Cached on the string.  */
+					k->u.s = c->cs
+						? go_string_get_collation (gs)
+						: go_string_get_casefolded_collate (gs);
+				else {
+					char *fold = c->cs
+						? NULL
+						: g_utf8_casefold (gs->str, -1);
+					char *key = g_utf8_collate_key
+						(fold ? fold : gs->str, -1);
+					k->u.s = g_string_chunk_insert (sk->pool, key);
+					g_free (key);
+					g_free (fold);
+				}
+			} else
+				k->kind = SORT_KEY_OTHER;
+		}
+	}
 }
 
-static int
-sort_qsort_compare_in_locale (void const *_a, void const *_b)
+static void
+sort_keys_clear (SortKeys *sk)
 {
-	SortDataPerm const *a = (SortDataPerm const *)_a;
-	SortDataPerm const *b = (SortDataPerm const *)_b;
-
-	return sort_compare_sets (a->data, a->index, b->index, FALSE);
+	g_free (sk->keys);
+	if (sk->pool)
+		g_string_chunk_free (sk->pool);
 }
 
+/*
+ * Stable bottom-up merge sort of the row (or column) indices in @idx.
+ */
+static void
+sort_merge (SortKeys const *sk, int *idx, int n)
+{
+	int *tmp, *src, *dst, width, i;
+
+	/* Insertion sort short runs.  */
+	for (i = 0; i < n; i += 16) {
+		int hi = MIN (i + 16, n), j;
+		for (j = i + 1; j < hi; j++) {
+			int x = idx[j], k = j;
+			while (k > i && sort_compare_sets (sk, idx[k - 1], x) > 0) {
+				idx[k] = idx[k - 1];
+				k--;
+			}
+			idx[k] = x;
+		}
+	}
+	if (n <= 16)
+		return;
+
+	tmp = g_new (int, n);
+	src = idx;
+	dst = tmp;
+	for (width = 16; width < n; width *= 2) {
+		for (i = 0; i < n; i += 2 * width) {
+			int lo = i, mid = MIN (i + width, n), hi = MIN (i + 2 * width, n);
+			int a = lo, b = mid, k = lo;
+
+			/* Already in order?  */
+			if (mid >= hi ||
+			    sort_compare_sets (sk, src[mid - 1], src[mid]) <= 0) {
+				memcpy (dst + lo, src + lo, (hi - lo) * sizeof (int));
+				continue;
+			}
+			while (a < mid && b < hi)
+				dst[k++] = (sort_compare_sets (sk, src[b], src[a]) < 0)
+					? src[b++] : src[a++];
+			while (a < mid)
+				dst[k++] = src[a++];
+			while (b < hi)
+				dst[k++] = src[b++];
+		}
+		src = dst;
+		dst = (dst == tmp) ? idx : tmp;
+	}
+	if (src != idx)
+		memcpy (idx, src, n * sizeof (int));
+	g_free (tmp);
+}
 
 static void
-sort_permute_range (GnmSortData const *data, GnmRange *range, int adj)
+sort_permute_range (GnmSortData const *data, GnmRange *range, int adj,
+		    int count)
 {
 	if (data->top) {
 		range->start.row = data->range->start.row + adj;
 		range->start.col = data->range->start.col;
-		range->end.row = range->start.row;
+		range->end.row = range->start.row + count - 1;
 		range->end.col = data->range->end.col;
 	} else {
 		range->start.row = data->range->start.row;
 		range->start.col = data->range->start.col + adj;
 		range->end.row = data->range->end.row;
-		range->end.col = range->start.col;
+		range->end.col = range->start.col + count - 1;
 	}
 }
 
@@ -179,12 +294,24 @@ gnm_sort_permute_invert (int const *perm, int length)
 
 #undef DEBUG_SORT
 
+typedef struct {
+	int dst;
+	int count;
+	GnmCellRegion *rcopy;
+} SortMove;
+
+/*
+ * Position i receives what was at perm[i].  Consecutive positions that
+ * receive consecutive rows are moved as one block, and all blocks are
+ * copied before any is pasted, so no cycle tracking is needed.
+ */
 static void
 sort_permute (GnmSortData *data, int const *perm, int length,
 	      GOCmdContext *cc)
 {
-	int i, *rperm;
+	int i;
 	GnmPasteTarget pt;
+	GArray *moves = g_array_new (FALSE, FALSE, sizeof (SortMove));
 
 	pt.sheet = data->sheet;
 	pt.paste_flags = PASTE_CONTENTS | PASTE_COMMENTS | PASTE_NO_RECALC;
@@ -198,59 +325,41 @@ sort_permute (GnmSortData *data, int const *perm, int length,
 	g_printerr ("\n");
 #endif
 
-	rperm = gnm_sort_permute_invert (perm, length);
-
-	for (i = 0; i < length; i++) {
-		GnmRange range1, range2;
-		GnmCellRegion *rcopy1, *rcopy2 = NULL;
-		int i1, i2;
+	for (i = 0; i < length; ) {
+		SortMove m;
+		GnmRange range;
 
 		/* Special case: element is already in place.  */
-		if (i == rperm[i]) {
-#ifdef DEBUG_SORT
-			g_printerr ("  Fixpoint: %d\n", i);
-#endif
+		if (perm[i] == i) {
+			i++;
 			continue;
 		}
 
-		/* Track a full cycle.  */
-		sort_permute_range (data, &range1, i);
-		rcopy1 = clipboard_copy_range (data->sheet, &range1);
+		m.dst = i;
+		m.count = 1;
+		while (i + m.count < length &&
+		       perm[i + m.count] == perm[i] + m.count)
+			m.count++;
 
+		sort_permute_range (data, &range, perm[i], m.count);
+		m.rcopy = clipboard_copy_range (data->sheet, &range);
+		g_array_append_val (moves, m);
 #ifdef DEBUG_SORT
-		g_printerr ("  Cycle:");
-#endif
-		i1 = i;
-		do {
-#ifdef DEBUG_SORT
-			g_printerr (" %d", i1);
+		g_printerr ("  Move: %d..%d -> %d\n",
+			    perm[i], perm[i] + m.count - 1, i);
 #endif
+		i += m.count;
+	}
 
-			i2 = rperm[i1];
-
-			sort_permute_range (data, &range2, i2);
-			if (i2 != i) {
-				/* Don't copy the start of the loop; we did that above.  */
-				rcopy2 = clipboard_copy_range (data->sheet, &range2);
-			}
-
-			pt.range = range2;
-			clipboard_paste_region (rcopy1, &pt, cc);
-			cellregion_unref (rcopy1);
-
-			/* This is one step behind.  */
-			rperm[i1] = i1;
+	for (i = 0; i < (int)moves->len; i++) {
+		SortMove *m = &g_array_index (moves, SortMove, i);
 
-			rcopy1 = rcopy2;
-			range1 = range2;
-			i1 = i2;
-		} while (i1 != i);
-#ifdef DEBUG_SORT
-		g_printerr ("\n");
-#endif
+		sort_permute_range (data, &pt.range, m->dst, m->count);
+		clipboard_paste_region (m->rcopy, &pt, cc);
+		cellregion_unref (m->rcopy);
 	}
 
-	g_free (rperm);
+	g_array_free (moves, TRUE);
 }
 
 void
@@ -266,62 +375,58 @@ int *
 gnm_sort_contents (GnmSortData *data, GOCmdContext *cc)
 {
 	ColRowInfo const *cra;
-	SortDataPerm *perm;
-	int length, real_length, i, cur, *iperm, *real;
+	int length, real_length, i, cur, *perm, *iperm;
+	char *real;
 	int const first = data->top ? data->range->start.row : data->range->start.col;
 
 	length = gnm_sort_data_length (data);
 	real_length = 0;
 
 	/* Discern the rows/cols to be actually sorted */
-	real = g_new (int, length);
+	real = g_new (char, length);
 	for (i = 0; i < length; i++) {
 		cra = data->top
 			? sheet_row_get (data->sheet, first + i)
 			: sheet_col_get (data->sheet, first + i);
 
-		if (cra && !cra->visible) {
-			real[i] = -1;
-		} else {
-			real[i] = i;
+		real[i] = !(cra && !cra->visible);
+		if (real[i])
 			real_length++;
-		}
 	}
 
 	cur = 0;
-	perm = g_new (SortDataPerm, real_length);
-	for (i = 0; i < length; i++) {
-		if (real[i] != -1) {
-			perm[cur].index = i;
-			perm[cur].data = data;
-			cur++;
-		}
-	}
+	perm = g_new (int, real_length);
+	for (i = 0; i < length; i++)
+		if (real[i])
+			perm[cur++] = i;
 
 	if (real_length > 1) {
+		SortKeys sk;
+
 		if (data->locale) {
 			char *old_locale
 				= g_strdup (go_setlocale (LC_ALL, NULL));
 			go_setlocale (LC_ALL, data->locale);
 
-			qsort (perm, real_length, sizeof (SortDataPerm),
-			       g_str_has_prefix
-			       (old_locale, data->locale)
-			       ? sort_qsort_compare
-			       : sort_qsort_compare_in_locale);
+			/* Collation keys depend on the locale.  */
+			sort_keys_init (&sk, data, real, length,
+					g_str_has_prefix (old_locale,
+							  data->locale));
 
 			go_setlocale (LC_ALL, old_locale);
 			g_free (old_locale);
 		} else
-			qsort (perm, real_length, sizeof (SortDataPerm),
-			       sort_qsort_compare);
+			sort_keys_init (&sk, data, real, length, TRUE);
+
+		sort_merge (&sk, perm, real_length);
+		sort_keys_clear (&sk);
 	}
 
 	cur = 0;
 	iperm = g_new (int, length);
 	for (i = 0; i < length; i++) {
-		if (real[i] != -1) {
-			iperm[i] = perm[cur].index;
+		if (real[i]) {
+			iperm[i] = perm[cur];
 			cur++;
 		} else {
 			iperm[i] = i;
@@ -342,6 +447,73 @@ gnm_sort_contents (GnmSortData *data, GOCmdContext *cc)
 	return iperm;
 }
 
+static int
+sort_float_compare (const void *a_, const void *b_)
+{
+	gnm_float const *a = a_;
+	gnm_float const *b = b_;
+
+	return (*a < *b) ? -1 : (*a > *b);
+}
+
+/**
+ * gnm_sort_floats:
+ * @xs: (array length=n): numbers to sort
+ * @n: number of elements in @xs
+ *
+ * Sorts @xs in increasing order.  Large arrays of doubles are sorted with
+ * a radix sort on their bit patterns.  NaNs are not allowed.
+ */
+void
+gnm_sort_floats (gnm_float *xs, size_t n)
+{
+#ifndef GNM_WITH_LONG_DOUBLE
+	if (n >= 256 && sizeof (gnm_float) == sizeof (guint64)) {
+		guint64 *keys = g_new (guint64, n);
+		guint64 *tmp = g_new (guint64, n);
+		size_t i, counts[256];
+		int shift;
+
+		/* Map to unsigned integers with the same order.  */
+		for (i = 0; i < n; i++) {
+			guint64 u;
+			memcpy (&u, xs + i, sizeof (u));
+			keys[i] = (u >> 63) ? ~u : (u | G_GUINT64_CONSTANT (0x8000000000000000));
+		}
+
+		for (shift = 0; shift < 64; shift += 8) {
+			size_t sum = 0;
+			guint64 *t;
+
+			memset (counts, 0, sizeof (counts));
+			for (i = 0; i < n; i++)
+				counts[(keys[i] >> shift) & 0xff]++;
+			/* Skip digits that are the same everywhere.  */
+			if (counts[(keys[0] >> shift) & 0xff] == n)
+				continue;
+			for (i = 0; i < 256; i++) {
+				size_t c = counts[i];
+				counts[i] = sum;
+				sum += c;
+			}
+			for (i = 0; i < n; i++)
+				tmp[counts[(keys[i] >> shift) & 0xff]++] = keys[i];
+			t = keys; keys = tmp; tmp = t;
+		}
+
+		for (i = 0; i < n; i++) {
+			guint64 u = keys[i];
+			u = (u >> 63) ? (u & ~G_GUINT64_CONSTANT (0x8000000000000000)) : ~u;
+			memcpy (xs + i, &u, sizeof (u));
+		}
+
+		g_free (keys);
+		g_free (tmp);
+		return;
+	}
+#endif
+	qsort (xs, n, sizeof (gnm_float), sort_float_compare);
+}
 
 GnmSortData *
 gnm_sort_data_copy   (GnmSortData *data)
@@ -29,6 +29,8 @@ void gnm_sort_position	     (GnmSortData *data, int *perm, GOCmdContext *cc);
 int *gnm_sort_contents	     (GnmSortData *data, GOCmdContext *cc);
 int *gnm_sort_permute_invert (int const *perm, int length);
 
+void gnm_sort_floats (gnm_float *xs, size_t n);
+
 G_END_DECLS
 
 #endif /* _GNM_SORT_H_ */
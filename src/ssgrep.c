@@ -43,6 +43,7 @@ static gboolean ssgrep_print_nonmatching_filenames = FALSE;
 static gboolean ssgrep_print_locus = FALSE;
 static gboolean ssgrep_print_type = FALSE;
 static char *ssgrep_pattern = NULL;
+static gboolean ssgrep_pattern_is_literal = FALSE;
 static gboolean ssgrep_fixed_strings = FALSE;
 static gboolean ssgrep_recalc = FALSE;
 static gboolean ssgrep_invert_match = FALSE;
@@ -302,7 +303,7 @@ ssgrep (const char *arg, char const *uri, GOIOContext *ioc, GHashTable *targets,
 	search = (GnmSearchReplace*)
 		g_object_new (GNM_SEARCH_REPLACE_TYPE,
 			      "search-text", ssgrep_pattern,
-			      "is-regexp", TRUE,
+			      "is-regexp", !ssgrep_pattern_is_literal,
 			      "invert", ssgrep_invert_match,
 			      "ignore-case", ssgrep_ignore_case,
 			      "match-words", ssgrep_match_words,
@@ -494,12 +495,9 @@ main (int argc, char const **argv)
 			return 1;
 		}
 
-		if (ssgrep_fixed_strings) {
-			GString *pat = g_string_new (NULL);
-			go_regexp_quote (pat, argv[1]);
-			ssgrep_pattern = g_string_free (pat, FALSE);
-		} else
-			ssgrep_pattern = g_strdup (argv[1]);
+		/* A single fixed string lets the search reject cells early.  */
+		ssgrep_pattern = g_strdup (argv[1]);
+		ssgrep_pattern_is_literal = ssgrep_fixed_strings;
 		add_target (ssgrep_targets, argv[1]);
 
 		i = 2;
@@ -28,6 +28,15 @@
 #include <sf-gamma.h>
 #include <rangefunc.h>
 #include <gnumeric-conf.h>
+#include <gnm-format.h>
+#include <print-cell.h>
+#include <print-info.h>
+#include <ranges.h>
+#include <sort.h>
+#include <clipboard.h>
+#include <sheet-autofill.h>
+#include <sheet-filter.h>
+#include <sheet-merge.h>
 
 #include <gsf/gsf-input-stdio.h>
 #include <gsf/gsf-input-textline.h>
@@ -35,6 +44,9 @@
 #include <glib/gi18n.h>
 #include <string.h>
 #include <errno.h>
+#ifdef CAIRO_HAS_PDF_SURFACE
+#include <cairo-pdf.h>
+#endif
 
 static gboolean sstest_show_version = FALSE;
 static gboolean sstest_fast = FALSE;
@@ -3587,83 +3599,1466 @@ test_recalc (GOCmdContext *cc, const char *url)
 
 /* ------------------------------------------------------------------------- */
 
-#define MAYBE_DO(name) if (strcmp (testname, "all") != 0 && strcmp (testname, (name)) != 0) { } else
+static double
+render_seconds_since (gint64 start)
+{
+	return (g_get_monotonic_time () - start) / 1e6;
+}
 
-int
-main (int argc, char const **argv)
+#ifdef CAIRO_HAS_PDF_SURFACE
+static cairo_status_t
+cb_render_discard (G_GNUC_UNUSED void *closure,
+		   G_GNUC_UNUSED unsigned char const *data,
+		   G_GNUC_UNUSED unsigned int length)
 {
-	GOErrorInfo	*plugin_errs;
-	GOCmdContext	*cc;
-	GOptionContext	*ocontext;
-	GError		*error = NULL;
-	const char *testname;
+	return CAIRO_STATUS_SUCCESS;
+}
+#endif
 
-	/* No code before here, we need to init threads */
-	argv = gnm_pre_parse_init (argc, argv);
+static void
+test_render_range (Sheet *sheet, GnmRange *r)
+{
+	static const double zooms[] = { 0.5, 1, 2 };
+	GODateConventions const *date_conv = sheet_date_conv (sheet);
+	GnmPrintInformation const *pinfo = sheet->print_info;
+	GPtrArray *cells = sheet_cells (sheet, r);
+	double width = sheet_col_get_distance_pts (sheet, r->start.col, r->end.col + 1);
+	double height = sheet_row_get_distance_pts (sheet, r->start.row, r->end.row + 1);
+	gint64 start;
+	unsigned ui, zi;
+
+	g_printerr ("%s!%s: %d cells, %.0fx%.0f points\n",
+		    sheet->name_unquoted, range_as_string (r),
+		    cells->len, width, height);
+
+	/* Formatting: values to strings only.  */
+	start = g_get_monotonic_time ();
+	for (ui = 0; ui < cells->len; ui++) {
+		GnmCell *cell = g_ptr_array_index (cells, ui);
+		if (cell->value)
+			g_free (format_value (gnm_cell_get_format (cell),
+					      cell->value, -1, date_conv));
+	}
+	g_printerr ("  format: %.3fs\n", render_seconds_since (start));
 
-	gnm_conf_set_persistence (FALSE);
+	/* Layout: full rendered values including pango layouts.  */
+	start = g_get_monotonic_time ();
+	for (ui = 0; ui < cells->len; ui++) {
+		GnmCell *cell = g_ptr_array_index (cells, ui);
+		gnm_cell_unrender (cell);
+		(void)gnm_cell_fetch_rendered_value (cell, TRUE);
+	}
+	g_printerr ("  layout: %.3fs\n", render_seconds_since (start));
 
-	ocontext = g_option_context_new (_("[testname]"));
-	g_option_context_add_main_entries (ocontext, sstest_options, GETTEXT_PACKAGE);
-	g_option_context_add_group	  (ocontext, gnm_get_option_group ());
-	g_option_context_parse (ocontext, &argc, (gchar ***)&argv, &error);
-	g_option_context_free (ocontext);
+	/* Drawing, including backgrounds and borders.  */
+	for (zi = 0; zi < G_N_ELEMENTS (zooms); zi++) {
+		double zoom = zooms[zi];
+		int w = CLAMP (width * zoom, 1, 4096);
+		int h = CLAMP (height * zoom, 1, 4096);
+		cairo_surface_t *surface =
+			cairo_image_surface_create (CAIRO_FORMAT_ARGB32, w, h);
+		cairo_t *cr = cairo_create (surface);
 
-	if (error) {
-		g_printerr (_("%s\nRun '%s --help' to see a full list of available command line options.\n"),
-			    error->message, g_get_prgname ());
-		g_error_free (error);
-		return 1;
+		cairo_scale (cr, zoom, zoom);
+		start = g_get_monotonic_time ();
+		gnm_gtk_print_cell_range (cr, sheet, r, 0, 0, pinfo);
+		cairo_surface_flush (surface);
+		g_printerr ("  draw at %3.0f%%: %.3fs\n",
+			    zoom * 100, render_seconds_since (start));
+
+		cairo_destroy (cr);
+		cairo_surface_destroy (surface);
 	}
 
-	if (sstest_show_version) {
-		g_printerr (_("version '%s'\ndatadir := '%s'\nlibdir := '%s'\n"),
-			    GNM_VERSION_FULL, gnm_sys_data_dir (), gnm_sys_lib_dir ());
-		return 0;
+#ifdef CAIRO_HAS_PDF_SURFACE
+	{
+		cairo_surface_t *surface =
+			cairo_pdf_surface_create_for_stream
+			(cb_render_discard, NULL, width, height);
+		cairo_t *cr = cairo_create (surface);
+
+		start = g_get_monotonic_time ();
+		gnm_gtk_print_cell_range (cr, sheet, r, 0, 0, pinfo);
+		cairo_show_page (cr);
+		cairo_surface_finish (surface);
+		g_printerr ("  pdf: %.3fs\n", render_seconds_since (start));
+
+		cairo_destroy (cr);
+		cairo_surface_destroy (surface);
 	}
+#endif
 
-	gnm_init ();
+	g_ptr_array_free (cells, TRUE);
+}
 
-	cc = gnm_cmd_context_stderr_new ();
-	gnm_plugins_init (GO_CMD_CONTEXT (cc));
-	go_plugin_db_activate_plugin_list (
-		go_plugins_get_available_plugins (), &plugin_errs);
-	if (plugin_errs) {
-		/* FIXME: What do we want to do here? */
-		go_error_info_free (plugin_errs);
+/*
+ * Headless rendering benchmark.  Renders the given range, or the extent of
+ * every sheet, through the print code paths and reports per-phase times.
+ */
+static void
+test_render (GOCmdContext *cc, const char *url, const char *range_text)
+{
+	GOIOContext *io_context = go_io_context_new (cc);
+	WorkbookView *wbv = workbook_view_new_from_uri (url, NULL, io_context, NULL);
+	Workbook *wb;
+
+	g_object_unref (io_context);
+	if (!wbv) {
+		g_printerr ("Failed to load %s\n", url);
+		return;
 	}
+	wb = wb_view_get_workbook (wbv);
 
-	if (func_state_file) {
-		function_dump_defs (func_state_file, 0);
-		goto done;
+	workbook_recalc_all (wb);
+
+	WORKBOOK_FOREACH_SHEET (wb, sheet, {
+		GnmRange r;
+
+		if (range_text) {
+			if (!range_parse (&r, range_text,
+					  gnm_sheet_get_size (sheet))) {
+				g_printerr ("Invalid range %s\n", range_text);
+				break;
+			}
+		} else
+			r = sheet_get_extent (sheet, TRUE, TRUE);
+
+		test_render_range (sheet, &r);
+	});
+
+	g_object_unref (wb);
+}
+
+/* ------------------------------------------------------------------------- */
+
+typedef int (*RangefuncImpl) (gnm_float const *xs, gnm_float const *ys,
+			      int n, gnm_float *res);
+
+/* Plain one-accumulator loops to compare the gnm_range_* versions with.  */
+
+static int
+rangefunc_avedev_scalar (gnm_float const *xs, G_GNUC_UNUSED gnm_float const *ys,
+			 int n, gnm_float *res)
+{
+	gnm_float m, s = 0;
+	int i;
+
+	gnm_range_average (xs, n, &m);
+	for (i = 0; i < n; i++)
+		s += gnm_abs (xs[i] - m);
+	*res = s / n;
+	return 0;
+}
+
+static int
+rangefunc_skew_pop_scalar (gnm_float const *xs, G_GNUC_UNUSED gnm_float const *ys,
+			   int n, gnm_float *res)
+{
+	gnm_float m, s, x3 = 0;
+	int i;
+
+	gnm_range_average (xs, n, &m);
+	gnm_range_stddev_pop (xs, n, &s);
+	for (i = 0; i < n; i++) {
+		gnm_float dxn = (xs[i] - m) / s;
+		x3 += dxn * dxn * dxn;
 	}
-	if (func_def_file) {
-		function_dump_defs (func_def_file, 1);
-		goto done;
+	*res = x3 / n;
+	return 0;
+}
+
+static int
+rangefunc_covar_pop_scalar (gnm_float const *xs, gnm_float const *ys,
+			    int n, gnm_float *res)
+{
+	gnm_float ux, uy, s = 0;
+	int i;
+
+	gnm_range_average (xs, n, &ux);
+	gnm_range_average (ys, n, &uy);
+	for (i = 0; i < n; i++)
+		s += (xs[i] - ux) * (ys[i] - uy);
+	*res = s / n;
+	return 0;
+}
+
+static int
+rangefunc_avedev (gnm_float const *xs, G_GNUC_UNUSED gnm_float const *ys,
+		  int n, gnm_float *res)
+{
+	return gnm_range_avedev (xs, n, res);
+}
+
+static int
+rangefunc_skew_pop (gnm_float const *xs, G_GNUC_UNUSED gnm_float const *ys,
+		    int n, gnm_float *res)
+{
+	return gnm_range_skew_pop (xs, n, res);
+}
+
+/*
+ * Sum the terms of the scalar versions with an exact accumulator.  Returns
+ * the correctly rounded result; *scale receives the same thing computed
+ * on the absolute values of the terms.
+ */
+static gnm_float
+rangefunc_exact (int which, gnm_float const *xs, gnm_float const *ys, int n,
+		 gnm_float *scale)
+{
+	void *state = gnm_accumulator_start ();
+	GnmAccumulator *acc = gnm_accumulator_new ();
+	gnm_float m, s, uy, t, abssum = 0, res;
+	int i;
+
+	gnm_range_average (xs, n, &m);
+	gnm_range_stddev_pop (xs, n, &s);
+	gnm_range_average (ys, n, &uy);
+
+	for (i = 0; i < n; i++) {
+		switch (which) {
+		case 0:
+			t = gnm_abs (xs[i] - m);
+			break;
+		case 1: {
+			gnm_float dxn = (xs[i] - m) / s;
+			t = dxn * dxn * dxn;
+			break;
+		}
+		default:
+			t = (xs[i] - m) * (ys[i] - uy);
+			break;
+		}
+		gnm_accumulator_add (acc, t);
+		abssum += gnm_abs (t);
 	}
-	if (ext_refs_file) {
-		function_dump_defs (ext_refs_file, 4);
-		goto done;
+
+	res = gnm_accumulator_value (acc) / n;
+	*scale = abssum / n;
+
+	gnm_accumulator_free (acc);
+	gnm_accumulator_end (state);
+	return res;
+}
+
+static double
+rangefunc_time (RangefuncImpl f, gnm_float const *xs, gnm_float const *ys,
+		int n, int reps, gnm_float *res)
+{
+	gint64 start = g_get_monotonic_time ();
+	int r;
+
+	for (r = 0; r < reps; r++)
+		f (xs, ys, n, res);
+
+	return (g_get_monotonic_time () - start) / 1e6;
+}
+
+/*
+ * Micro-benchmark for the multi-lane reductions in rangefunc.c.  Errors are
+ * measured in units of GNM_EPSILON times the mean absolute term.  With
+ * Kahan-compensated lanes the bound is a few such units regardless of n;
+ * a single plain accumulator has n+4.
+ */
+static void
+test_rangefunc (int max_exp)
+{
+	static const struct {
+		const char *name;
+		RangefuncImpl fast, scalar;
+	} tests[] = {
+		{ "avedev", rangefunc_avedev, rangefunc_avedev_scalar },
+		{ "skew_pop", rangefunc_skew_pop, rangefunc_skew_pop_scalar },
+		{ "covar_pop", gnm_range_covar_pop, rangefunc_covar_pop_scalar }
+	};
+	int e, n;
+	unsigned ui;
+	gboolean ok = TRUE;
+
+	mark_test_start ("test_rangefunc");
+
+	for (e = 3, n = 1000; e <= max_exp; e++, n *= 10) {
+		gnm_float *xs = g_new (gnm_float, n);
+		gnm_float *ys = g_new (gnm_float, n);
+		int i, reps = MAX (1, 10000000 / n);
+
+		for (i = 0; i < n; i++) {
+			xs[i] = random_01 () * 100 - 20;
+			ys[i] = random_01 () * 10 + xs[i] / 4;
+		}
+
+		for (ui = 0; ui < G_N_ELEMENTS (tests); ui++) {
+			gnm_float fast, scalar, exact, scale;
+			double t_fast, t_scalar, err_fast, err_scalar;
+			double bound = 4;
+
+			t_scalar = rangefunc_time (tests[ui].scalar, xs, ys, n,
+						   reps, &scalar);
+			t_fast = rangefunc_time (tests[ui].fast, xs, ys, n,
+						 reps, &fast);
+			exact = rangefunc_exact (ui, xs, ys, n, &scale);
+			err_fast = gnm_abs (fast - exact) / (GNM_EPSILON * scale);
+			err_scalar = gnm_abs (scalar - exact) / (GNM_EPSILON * scale);
+
+			g_printerr ("%-10s n=%-9d %8.4fs (scalar %8.4fs)  error %.1f (scalar %.1f)\n",
+				    tests[ui].name, n,
+				    t_fast / reps, t_scalar / reps,
+				    err_fast, err_scalar);
+			if (err_fast > bound) {
+				g_printerr ("FAIL: %s error exceeds %.1f\n",
+					    tests[ui].name, bound);
+				ok = FALSE;
+			}
+		}
+
+		g_free (xs);
+		g_free (ys);
 	}
-	if (samples_file) {
-		function_dump_defs (samples_file, 5);
-		goto done;
+
+	if (ok)
+		g_printerr ("All errors within bounds.\n");
+
+	mark_test_end ("test_rangefunc");
+}
+
+/* ------------------------------------------------------------------------- */
+
+static gboolean
+expr_program_same (GnmValue const *a, GnmValue const *b)
+{
+	GOFormat const *fa, *fb;
+
+	if (a == NULL || b == NULL)
+		return a == b;
+	if (!value_equal (a, b))
+		return FALSE;
+	fa = VALUE_FMT (a);
+	fb = VALUE_FMT (b);
+	return fa == fb || (fa && fb && go_format_eq (fa, fb));
+}
+
+/*
+ * Evaluate formulas both through compiled expression programs and through
+ * the tree evaluator over a grid of mixed values, and compare.
+ */
+static void
+test_expr_program (void)
+{
+	static const char *vals[] = {
+		NULL, "3", "-2", "0", "0.5", "1e300", "'12", "'abc",
+		"TRUE", "FALSE", "=1/0", "=NA()", "5%", "2020-01-01",
+		"=\"\""
+	};
+	static const char *exprs[] = {
+		"=IF(A1>0,B1*C1/D1,0)",
+		"=A1+B1-C1*D1",
+		"=A1/B1",
+		"=A1^B1",
+		"=-A1",
+		"=A1%",
+		"=+A1*1",
+		"=A1=B1",
+		"=A1<>\"abc\"",
+		"=A1<=B1",
+		"=(A1>B1)+(C1<D1)",
+		"=IF(A1,B1)",
+		"=IF(A1<B1,,C1)",
+		"=IF(A1>1,C1,D1)=0",
+		"=IF(A1,B1,C1)<>\"\"",
+		"=-(A1+B1)",
+		"=SUM(A1:B1)*2+C1",
+		"=(A1&B1)<>\"\"",
+		"=IF(ISERROR(A1),1,A1)/2",
+		"=IF(A1>0,-B1,IF(B1>0,C1%,D1))",
+		"=A1+B1:B2*2"
+	};
+	int nv = G_N_ELEMENTS (vals);
+	int rows = nv * nv, cols = 8;
+	Workbook *wb = workbook_new ();
+	Sheet *sheet;
+	GnmParsePos pp;
+	unsigned ui;
+	int r, c, bad = 0;
+
+	mark_test_start ("test_expr_program");
+
+	gnm_sheet_suggest_size (&cols, &rows);
+	sheet = workbook_sheet_add (wb, -1, cols, rows);
+
+	for (r = 0; r < nv * nv; r++) {
+		int pick[4];
+		pick[0] = r % nv;
+		pick[1] = (r / nv) % nv;
+		pick[2] = (r * 3 + 1) % nv;
+		pick[3] = (r * 5 + 2) % nv;
+		for (c = 0; c < 4; c++)
+			if (vals[pick[c]])
+				define_cell (sheet, c, r, vals[pick[c]]);
+	}
+	workbook_recalc (wb);
+
+	parse_pos_init (&pp, wb, sheet, 5, 0);
+	for (ui = 0; ui < G_N_ELEMENTS (exprs); ui++) {
+		GnmExprTop const *texpr =
+			gnm_expr_parse_str (exprs[ui], &pp,
+					    GNM_EXPR_PARSE_DEFAULT,
+					    gnm_conventions_default, NULL);
+
+		if (!texpr) {
+			g_printerr ("FAIL: cannot parse %s\n", exprs[ui]);
+			bad++;
+			continue;
+		}
+
+		for (r = 0; r < nv * nv; r++) {
+			GnmEvalPos ep;
+			GnmValue *vp, *vt;
+
+			eval_pos_init (&ep, sheet, 5, r);
+			vp = gnm_expr_top_eval (texpr, &ep,
+						GNM_EXPR_EVAL_SCALAR_NON_EMPTY);
+			vt = gnm_expr_eval (texpr->expr, &ep,
+					    GNM_EXPR_EVAL_SCALAR_NON_EMPTY);
+			if (!expr_program_same (vp, vt)) {
+				char *sp = vp ? value_get_as_string (vp) : g_strdup ("NULL");
+				char *st = vt ? value_get_as_string (vt) : g_strdup ("NULL");
+				g_printerr ("FAIL: %s on row %d gives %s, expected %s\n",
+					    exprs[ui], r + 1, sp, st);
+				g_free (sp);
+				g_free (st);
+				bad++;
+			}
+			value_release (vp);
+			value_release (vt);
+		}
+		gnm_expr_top_unref (texpr);
 	}
 
-	testname = argv[1];
-	if (!testname) testname = "all";
+	if (bad == 0)
+		g_printerr ("All results agree with the tree evaluator.\n");
 
-	/* ---------------------------------------- */
+	g_object_unref (wb);
 
-	MAYBE_DO ("test_insdel_rowcol_names") test_insdel_rowcol_names ();
-	MAYBE_DO ("test_insert_delete") test_insert_delete ();
-	MAYBE_DO ("test_func_help") test_func_help ();
-	MAYBE_DO ("test_nonascii_numbers") test_nonascii_numbers ();
-	MAYBE_DO ("test_random") test_random ();
-	if (argc > 2) {
-		MAYBE_DO ("test_recalc") {
-			char *url = go_shell_arg_to_uri (argv[2]);
-			test_recalc (cc, url);
+	mark_test_end ("test_expr_program");
+}
+
+/* ------------------------------------------------------------------------- */
+
+/*
+ * Recalculate many identical calls of pure functions and check that the
+ * memo answers them and gives the same values as direct calls.
+ */
+static void
+test_func_memo (void)
+{
+	int N = 2000, cols = 2, rows = N;
+	Workbook *wb = workbook_new ();
+	Sheet *sheet;
+	guint hits0, misses0, hits, misses, entries;
+	int r;
+	gboolean ok = TRUE;
+
+	mark_test_start ("test_func_memo");
+
+	gnm_sheet_suggest_size (&cols, &rows);
+	sheet = workbook_sheet_add (wb, -1, cols, rows);
+
+	for (r = 0; r < N; r++) {
+		define_cell (sheet, 0, r, "=NORMINV(0.95,0,1)");
+		define_cell (sheet, 1, r, "=TINV(0.05,MOD(ROW(),10)+1)");
+	}
+
+	gnm_func_memo_get_stats (&hits0, &misses0, NULL);
+	workbook_recalc (wb);
+	gnm_func_memo_get_stats (&hits, &misses, &entries);
+	hits -= hits0;
+	misses -= misses0;
+	g_printerr ("Hits: %u, misses: %u, entries: %u\n",
+		    hits, misses, entries);
+
+	for (r = 0; r < N; r++) {
+		GnmEvalPos ep;
+		GnmValue *args[2], *v;
+		GnmValue const *got = sheet_cell_get (sheet, 1, r)->value;
+
+		eval_pos_init (&ep, sheet, 1, r);
+		args[0] = value_new_float (0.05);
+		args[1] = value_new_int ((r + 1) % 10 + 1);
+		v = function_call_with_values (&ep, "tinv", 2,
+					       (GnmValue const * const *)args);
+		if (!value_equal (v, got)) {
+			g_printerr ("FAIL: TINV differs on row %d\n", r + 1);
+			ok = FALSE;
+		}
+		value_release (v);
+		value_release (args[0]);
+		value_release (args[1]);
+	}
+
+	if (misses > 11 || hits + misses < 2 * (guint)N) {
+		g_printerr ("FAIL: memo was not used\n");
+		ok = FALSE;
+	}
+
+	if (ok)
+		g_printerr ("Memo results are consistent.\n");
+
+	g_object_unref (wb);
+
+	mark_test_end ("test_func_memo");
+}
+
+/* ------------------------------------------------------------------------- */
+
+static void
+test_vector_funcs (void)
+{
+	static char const *funcs[] = {
+		"LN", "EXP", "GAMMALN", "NORMSDIST", "NORMSINV"
+	};
+	int N = 2000, cols = 2 * G_N_ELEMENTS (funcs) + 1, rows = N;
+	Workbook *wb = workbook_new ();
+	Sheet *sheet;
+	GnmParsePos pp;
+	unsigned ui;
+	int r;
+	gboolean ok = TRUE;
+
+	mark_test_start ("test_vector_funcs");
+
+	gnm_sheet_suggest_size (&cols, &rows);
+	sheet = workbook_sheet_add (wb, -1, cols, rows);
+
+	for (r = 0; r < N; r++) {
+		char *txt;
+
+		if (r % 17 == 0)
+			continue;
+		else if (r % 23 == 0)
+			txt = g_strdup ("abc");
+		else if (r % 29 == 0)
+			txt = g_strdup ("'0.25");
+		else if (r % 31 == 0)
+			txt = g_strdup ("=1/0");
+		else
+			txt = g_strdup_printf ("%.3f", (r - N / 2) * 0.013);
+		define_cell (sheet, 0, r, txt);
+		g_free (txt);
+	}
+
+	for (ui = 0; ui < G_N_ELEMENTS (funcs); ui++) {
+		char *txt = g_strdup_printf ("=%s(A1:A%d)", funcs[ui], N);
+		GnmExprTop const *texpr;
+
+		parse_pos_init_sheet (&pp, sheet);
+		texpr = gnm_expr_parse_str (txt, &pp, GNM_EXPR_PARSE_DEFAULT,
+					    gnm_conventions_default, NULL);
+		gnm_cell_set_array_formula (sheet, 1 + ui, 0, 1 + ui, N - 1,
+					    texpr);
+		g_free (txt);
+
+		for (r = 0; r < N; r++) {
+			txt = g_strdup_printf ("=%s(A%d)", funcs[ui], r + 1);
+			define_cell (sheet, 1 + G_N_ELEMENTS (funcs) + ui, r, txt);
+			g_free (txt);
+		}
+	}
+
+	workbook_recalc (wb);
+
+	for (ui = 0; ui < G_N_ELEMENTS (funcs); ui++) {
+		for (r = 0; r < N; r++) {
+			GnmValue const *got =
+				sheet_cell_get (sheet, 1 + ui, r)->value;
+			GnmValue const *want =
+				sheet_cell_get (sheet, 1 + G_N_ELEMENTS (funcs) + ui, r)->value;
+			if (!value_equal (got, want)) {
+				char *sg = value_get_as_string (got);
+				char *sw = value_get_as_string (want);
+				g_printerr ("FAIL: %s on row %d gives %s, not %s\n",
+					    funcs[ui], r + 1, sg, sw);
+				g_free (sg);
+				g_free (sw);
+				ok = FALSE;
+			}
+		}
+	}
+
+	if (ok)
+		g_printerr ("Vector results are consistent.\n");
+
+	g_object_unref (wb);
+
+	mark_test_end ("test_vector_funcs");
+}
+
+/* ------------------------------------------------------------------------- */
+
+static int
+test_sort_float_cmp (const void *a_, const void *b_)
+{
+	gnm_float const *a = a_, *b = b_;
+	return (*a < *b) ? -1 : (*a > *b);
+}
+
+static int
+test_sort_class (GnmValue const *v)
+{
+	if (VALUE_IS_EMPTY (v))
+		return 2;
+	return VALUE_IS_STRING (v) ? 1 : 0;
+}
+
+static void
+test_sort (void)
+{
+	static char const *words[] = { "pear", "Apple", "apple", "fig", "Fig" };
+	int N = 5000, cols = 2, rows = N;
+	gnm_float *xs = g_new (gnm_float, N), *ys = g_new (gnm_float, N);
+	Workbook *wb = workbook_new ();
+	Sheet *sheet;
+	GnmSortData *data;
+	GnmSortClause *clause;
+	GnmRange r;
+	int i, *perm;
+	gboolean ok = TRUE;
+	gnm_float sum = 0;
+
+	mark_test_start ("test_sort");
+
+	for (i = 0; i < N; i++)
+		xs[i] = ys[i] = (random_01 () - 0.5) * gnm_pow (10, i % 40 - 20);
+	gnm_sort_floats (xs, N);
+	qsort (ys, N, sizeof (gnm_float), test_sort_float_cmp);
+	for (i = 0; i < N; i++) {
+		if (xs[i] != ys[i]) {
+			g_printerr ("FAIL: float sort differs at %d\n", i);
+			ok = FALSE;
+			break;
+		}
+	}
+
+	gnm_sheet_suggest_size (&cols, &rows);
+	sheet = workbook_sheet_add (wb, -1, cols, rows);
+	for (i = 0; i < N; i++) {
+		char *txt;
+
+		if (i % 7 == 0) {
+			/* Leave blank.  */
+		} else if (i % 5 == 0)
+			define_cell (sheet, 0, i, words[(i / 5) % G_N_ELEMENTS (words)]);
+		else {
+			txt = g_strdup_printf ("%d", (i * 37) % 11);
+			define_cell (sheet, 0, i, txt);
+			g_free (txt);
+		}
+		txt = g_strdup_printf ("%d", i);
+		define_cell (sheet, 1, i, txt);
+		g_free (txt);
+	}
+
+	range_init (&r, 0, 0, 1, N - 1);
+	clause = g_new0 (GnmSortClause, 1);
+	clause->offset = 0;
+	clause->asc = FALSE;
+	clause->cs = FALSE;
+	clause->val = TRUE;
+	data = g_new0 (GnmSortData, 1);
+	data->sheet = sheet;
+	data->range = g_memdup (&r, sizeof (r));
+	data->num_clause = 1;
+	data->clauses = clause;
+	data->top = TRUE;
+	perm = gnm_sort_contents (data, NULL);
+
+	for (i = 0; i < N; i++) {
+		GnmCell const *cell = sheet_cell_get (sheet, 0, i);
+		GnmValue const *v = cell ? cell->value : NULL;
+		gnm_float b = value_get_as_float (sheet_cell_get (sheet, 1, i)->value);
+
+		sum += b;
+		if (perm[i] != (int)b) {
+			g_printerr ("FAIL: permutation does not match on row %d\n", i + 1);
+			ok = FALSE;
+		}
+		if (i > 0) {
+			GnmCell const *pcell = sheet_cell_get (sheet, 0, i - 1);
+			GnmValue const *pv = pcell ? pcell->value : NULL;
+			gnm_float pb = value_get_as_float (sheet_cell_get (sheet, 1, i - 1)->value);
+			int pc = test_sort_class (pv), c = test_sort_class (v);
+			int cmp = pc - c;
+
+			if (cmp == 0 && c == 0)
+				cmp = test_sort_float_cmp (&pv->v_float.val, &v->v_float.val);
+			else if (cmp == 0 && c == 1)
+				cmp = go_utf8_collate_casefold (value_peek_string (pv),
+								value_peek_string (v));
+			if (cmp > 0 || (cmp == 0 && pb > b)) {
+				g_printerr ("FAIL: rows %d and %d are out of order\n",
+					    i, i + 1);
+				ok = FALSE;
+			}
+		}
+	}
+	if (sum != (gnm_float)N * (N - 1) / 2) {
+		g_printerr ("FAIL: rows were lost\n");
+		ok = FALSE;
+	}
+
+	if (ok)
+		g_printerr ("Sort results are consistent.\n");
+
+	g_free (perm);
+	gnm_sort_data_destroy (data);
+	g_object_unref (wb);
+	g_free (xs);
+	g_free (ys);
+
+	mark_test_end ("test_sort");
+}
+
+/* ------------------------------------------------------------------------- */
+
+static int
+test_relocate_row (int r, int at, int count)
+{
+	return r >= at ? r + count : r;
+}
+
+static gboolean
+test_relocate_check (Sheet *sheet, int N, int at, int count)
+{
+	gboolean ok = TRUE;
+	int r;
+
+	for (r = 1; r <= N; r++) {
+		int nr = test_relocate_row (r, at, count);
+		char *want[4], *got;
+		int c;
+
+		want[0] = g_strdup_printf ("=A%d*2", nr);
+		want[1] = g_strdup_printf ("=$A$1+A%d", nr);
+		want[2] = g_strdup_printf ("=SUM(A$1:A%d)", nr);
+		want[3] = g_strdup_printf ("=A%d-A%d",
+					   test_relocate_row (r + 1, at, count), nr);
+		for (c = 0; c < 4; c++) {
+			got = gnm_cell_get_entered_text
+				(sheet_cell_get (sheet, 1 + c, nr - 1));
+			if (g_strcmp0 (got, want[c]) != 0) {
+				g_printerr ("FAIL: got %s instead of %s\n",
+					    got, want[c]);
+				ok = FALSE;
+			}
+			g_free (got);
+			g_free (want[c]);
+		}
+	}
+
+	return ok;
+}
+
+static void
+test_relocate (void)
+{
+	int N = 500, at = 101, count = 3, cols = 5, rows = N + count + 1;
+	Workbook *wb = workbook_new ();
+	Sheet *sheet;
+	GOUndo *undo = NULL;
+	int r;
+	gboolean ok = TRUE;
+
+	mark_test_start ("test_relocate");
+
+	gnm_sheet_suggest_size (&cols, &rows);
+	sheet = workbook_sheet_add (wb, -1, cols, rows);
+
+	for (r = 1; r <= N; r++) {
+		char *txt;
+
+		txt = g_strdup_printf ("%d", r);
+		define_cell (sheet, 0, r - 1, txt);
+		g_free (txt);
+		txt = g_strdup_printf ("=A%d*2", r);
+		define_cell (sheet, 1, r - 1, txt);
+		g_free (txt);
+		txt = g_strdup_printf ("=$A$1+A%d", r);
+		define_cell (sheet, 2, r - 1, txt);
+		g_free (txt);
+		txt = g_strdup_printf ("=SUM(A$1:A%d)", r);
+		define_cell (sheet, 3, r - 1, txt);
+		g_free (txt);
+		txt = g_strdup_printf ("=A%d-A%d", r + 1, r);
+		define_cell (sheet, 4, r - 1, txt);
+		g_free (txt);
+	}
+
+	sheet_insert_rows (sheet, at - 1, count, &undo, NULL);
+	if (!test_relocate_check (sheet, N, at, count))
+		ok = FALSE;
+
+	workbook_recalc (wb);
+	for (r = 1; r <= N; r++) {
+		int nr = test_relocate_row (r, at, count);
+		GnmValue const *v = sheet_cell_get (sheet, 1, nr - 1)->value;
+		if (value_get_as_float (v) != 2 * r) {
+			g_printerr ("FAIL: wrong value on row %d\n", nr);
+			ok = FALSE;
+		}
+	}
+
+	go_undo_undo (undo);
+	g_object_unref (undo);
+	if (!test_relocate_check (sheet, N, at, 0))
+		ok = FALSE;
+
+	/* A relative range down to the last row stays pinned there.  */
+	{
+		int last = gnm_sheet_get_max_rows (sheet);
+		char *txt, *want, *got;
+
+		txt = g_strdup_printf ("=SUM(G6:G%d)", last);
+		define_cell (sheet, 5, 4, txt);
+		g_free (txt);
+
+		sheet_delete_rows (sheet, 1, 2, &undo, NULL);
+		want = g_strdup_printf ("=SUM(G4:G%d)", last);
+		got = gnm_cell_get_entered_text (sheet_cell_get (sheet, 5, 2));
+		if (g_strcmp0 (got, want) != 0) {
+			g_printerr ("FAIL: got %s instead of %s\n", got, want);
+			ok = FALSE;
+		}
+		g_free (got);
+		g_free (want);
+
+		go_undo_undo (undo);
+		g_object_unref (undo);
+		want = g_strdup_printf ("=SUM(G6:G%d)", last);
+		got = gnm_cell_get_entered_text (sheet_cell_get (sheet, 5, 4));
+		if (g_strcmp0 (got, want) != 0) {
+			g_printerr ("FAIL: got %s instead of %s after undo\n",
+				    got, want);
+			ok = FALSE;
+		}
+		g_free (got);
+		g_free (want);
+	}
+
+	if (ok)
+		g_printerr ("Relocated expressions are consistent.\n");
+
+	g_object_unref (wb);
+
+	mark_test_end ("test_relocate");
+}
+
+static void
+test_paste (void)
+{
+	int N = 200, cols = 8, rows = N + 1;
+	Workbook *wb = workbook_new ();
+	Sheet *sheet;
+	GnmCellRegion *cr;
+	GnmPasteTarget pt;
+	GnmRange src, dst;
+	GnmCell *cell;
+	char *got;
+	int r;
+	gboolean ok = TRUE;
+
+	mark_test_start ("test_paste");
+
+	gnm_sheet_suggest_size (&cols, &rows);
+	sheet = workbook_sheet_add (wb, -1, cols, rows);
+
+	for (r = 1; r <= N; r++) {
+		char *txt;
+
+		txt = g_strdup_printf ("%d", r);
+		define_cell (sheet, 0, r - 1, txt);
+		g_free (txt);
+		txt = g_strdup_printf ("=A%d*2", r);
+		define_cell (sheet, 1, r - 1, txt);
+		g_free (txt);
+	}
+
+	/* A2:B<N> to D1: unchanged formulas must share the copied one.  */
+	range_init (&src, 0, 1, 1, N - 1);
+	range_init (&dst, 3, 0, 4, N - 2);
+	cr = clipboard_copy_range (sheet, &src);
+	clipboard_paste_region (cr, paste_target_init (&pt, sheet, &dst,
+						      PASTE_DEFAULT), NULL);
+	cellregion_unref (cr);
+
+	for (r = 2; r <= N; r++) {
+		char *want = g_strdup_printf ("=D%d*2", r - 1);
+		cell = sheet_cell_get (sheet, 4, r - 2);
+		got = gnm_cell_get_entered_text (cell);
+		if (g_strcmp0 (got, want) != 0) {
+			g_printerr ("FAIL: got %s instead of %s\n", got, want);
+			ok = FALSE;
+		}
+		if (cell->base.texpr != sheet_cell_get (sheet, 1, r - 1)->base.texpr) {
+			g_printerr ("FAIL: expression on row %d not shared\n", r - 1);
+			ok = FALSE;
+		}
+		g_free (got);
+		g_free (want);
+	}
+
+	/* F2 to G1 still needs the relocation to notice the bad reference.  */
+	define_cell (sheet, 5, 1, "=E1");
+	range_init (&src, 5, 1, 5, 1);
+	range_init (&dst, 6, 0, 6, 0);
+	cr = clipboard_copy_range (sheet, &src);
+	clipboard_paste_region (cr, paste_target_init (&pt, sheet, &dst,
+						      PASTE_DEFAULT), NULL);
+	cellregion_unref (cr);
+	got = gnm_cell_get_entered_text (sheet_cell_get (sheet, 6, 0));
+	if (g_strcmp0 (got, "=#REF!") != 0) {
+		g_printerr ("FAIL: got %s instead of =#REF!\n", got);
+		ok = FALSE;
+	}
+	g_free (got);
+
+	if (ok)
+		g_printerr ("Pasted expressions are consistent.\n");
+
+	g_object_unref (wb);
+
+	mark_test_end ("test_paste");
+}
+
+static void
+test_autofill (void)
+{
+	int N = 200, cols = 4, rows = N + 1;
+	Workbook *wb = workbook_new ();
+	Sheet *sheet;
+	GnmCell *first;
+	int r;
+	gboolean ok = TRUE;
+
+	mark_test_start ("test_autofill");
+
+	gnm_sheet_suggest_size (&cols, &rows);
+	sheet = workbook_sheet_add (wb, -1, cols, rows);
+
+	define_cell (sheet, 0, 0, "=B1*2");
+	define_cell (sheet, 1, 0, "1");
+	define_cell (sheet, 1, 1, "3");
+	gnm_autofill_fill (sheet, FALSE, 0, 0, 1, 1, 0, N - 1);
+	gnm_autofill_fill (sheet, FALSE, 1, 0, 1, 2, 1, N - 1);
+
+	first = sheet_cell_get (sheet, 0, 0);
+	for (r = 1; r <= N; r++) {
+		char *want = g_strdup_printf ("=B%d*2", r);
+		GnmCell *cell = sheet_cell_get (sheet, 0, r - 1);
+		char *got = gnm_cell_get_entered_text (cell);
+		if (g_strcmp0 (got, want) != 0) {
+			g_printerr ("FAIL: got %s instead of %s\n", got, want);
+			ok = FALSE;
+		}
+		if (cell->base.texpr != first->base.texpr) {
+			g_printerr ("FAIL: expression on row %d not shared\n", r);
+			ok = FALSE;
+		}
+		g_free (got);
+		g_free (want);
+
+		cell = sheet_cell_get (sheet, 1, r - 1);
+		if (value_get_as_float (cell->value) != 2 * r - 1) {
+			g_printerr ("FAIL: wrong series value on row %d\n", r);
+			ok = FALSE;
+		}
+	}
+
+	if (ok)
+		g_printerr ("Filled cells are consistent.\n");
+
+	g_object_unref (wb);
+
+	mark_test_end ("test_autofill");
+}
+
+static gboolean
+test_filter_check (Sheet *sheet, int N, int kind)
+{
+	int r;
+
+	for (r = 1; r <= N; r++) {
+		gboolean want = kind == 1
+			? (r % 7 == 3 && r > N - 7 * 20)
+			: (r % 7 == 4 && r > N - 20);
+		if (want == sheet_row_is_hidden (sheet, r)) {
+			g_printerr ("FAIL: wrong visibility for row %d\n", r + 1);
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+static void
+test_filter (void)
+{
+	int N = 1000, cols = 2, rows = N + 1;
+	Workbook *wb = workbook_new ();
+	Sheet *sheet;
+	GnmFilter *filter;
+	GnmRange range;
+	int r;
+	gboolean ok = TRUE;
+
+	mark_test_start ("test_filter");
+
+	gnm_sheet_suggest_size (&cols, &rows);
+	sheet = workbook_sheet_add (wb, -1, cols, rows);
+
+	define_cell (sheet, 0, 0, "Number");
+	define_cell (sheet, 1, 0, "Class");
+	for (r = 1; r <= N; r++) {
+		char *txt;
+
+		txt = g_strdup_printf ("%d", r);
+		define_cell (sheet, 0, r, txt);
+		g_free (txt);
+		txt = g_strdup_printf ("%d", r % 7);
+		define_cell (sheet, 1, r, txt);
+		g_free (txt);
+	}
+
+	range_init (&range, 0, 0, 1, N);
+	filter = gnm_filter_new (sheet, &range, TRUE);
+
+	/* Adding conditions applies them on top of each other.  */
+	gnm_filter_set_condition (filter, 1,
+		gnm_filter_condition_new_single (GNM_FILTER_OP_EQUAL,
+						 value_new_int (3)),
+		TRUE);
+	gnm_filter_set_condition (filter, 0,
+		gnm_filter_condition_new_bucket (TRUE, TRUE, FALSE, 20),
+		TRUE);
+	if (!test_filter_check (sheet, N, 1))
+		ok = FALSE;
+
+	/* Changing one reapplies all fields in order.  */
+	gnm_filter_set_condition (filter, 1,
+		gnm_filter_condition_new_single (GNM_FILTER_OP_EQUAL,
+						 value_new_int (4)),
+		TRUE);
+	if (!test_filter_check (sheet, N, 2))
+		ok = FALSE;
+
+	if (ok)
+		g_printerr ("Filtered rows are consistent.\n");
+
+	g_object_unref (wb);
+
+	mark_test_end ("test_filter");
+}
+
+static gboolean
+test_merge_check (Sheet *sheet, int cols, int rows)
+{
+	int c, r;
+
+	for (r = 0; r < rows; r++) {
+		for (c = 0; c < cols; c++) {
+			GnmCellPos pos;
+			GnmRange const *want = NULL, *got;
+			GnmRange q;
+			GSList *l, *overlap;
+			unsigned n = 0;
+
+			pos.col = c;
+			pos.row = r;
+			for (l = sheet->list_merged; l; l = l->next)
+				if (range_contains (l->data, c, r))
+					want = l->data;
+			got = gnm_sheet_merge_contains_pos (sheet, &pos);
+			if (got != want) {
+				g_printerr ("FAIL: wrong merge at %s\n",
+					    cellpos_as_string (&pos));
+				return FALSE;
+			}
+
+			range_init (&q, c, r, c + 2, r + 70);
+			for (l = sheet->list_merged; l; l = l->next)
+				if (range_overlap (&q, l->data))
+					n++;
+			overlap = gnm_sheet_merge_get_overlap (sheet, &q);
+			if (g_slist_length (overlap) != n) {
+				g_printerr ("FAIL: wrong overlap for %s\n",
+					    range_as_string (&q));
+				g_slist_free (overlap);
+				return FALSE;
+			}
+			g_slist_free (overlap);
+		}
+	}
+	return TRUE;
+}
+
+static void
+test_merge (void)
+{
+	int cols = 20, rows = 400;
+	Workbook *wb = workbook_new ();
+	Sheet *sheet;
+	GOUndo *undo = NULL;
+	GnmRange tall;
+	int c, r;
+	gboolean ok = TRUE;
+
+	mark_test_start ("test_merge");
+
+	gnm_sheet_suggest_size (&cols, &rows);
+	sheet = workbook_sheet_add (wb, -1, cols, rows);
+
+	for (r = 0; r + 100 < 300; r += 7)
+		for (c = 0; c + 3 < 20; c += 4) {
+			GnmRange m;
+			GSList *overlap;
+
+			range_init (&m, c, r, c + 1 + (r % 3), r + 3 * c + 1);
+			overlap = gnm_sheet_merge_get_overlap (sheet, &m);
+			if (overlap == NULL)
+				gnm_sheet_merge_add (sheet, &m, FALSE, NULL);
+			g_slist_free (overlap);
+		}
+
+	/* Regions spanning many blocks of rows.  */
+	range_init (&tall, 21, 5, 22, 390);
+	gnm_sheet_merge_add (sheet, &tall, FALSE, NULL);
+	range_init (&tall, 23, 0, 23, 299);
+	gnm_sheet_merge_add (sheet, &tall, FALSE, NULL);
+
+	if (!test_merge_check (sheet, 24, 300))
+		ok = FALSE;
+
+	sheet_insert_rows (sheet, 60, 10, &undo, NULL);
+	if (!test_merge_check (sheet, 24, 300))
+		ok = FALSE;
+
+	go_undo_undo (undo);
+	g_object_unref (undo);
+	if (!test_merge_check (sheet, 24, 300))
+		ok = FALSE;
+
+	if (ok)
+		g_printerr ("Merged regions are consistent.\n");
+
+	g_object_unref (wb);
+
+	mark_test_end ("test_merge");
+}
+
+/* ------------------------------------------------------------------------- */
+
+static int
+test_name_users_row (GnmNamedExpr *nexpr)
+{
+	GnmValue *v = gnm_expr_top_get_range (nexpr->texpr);
+	int row = v ? v->v_range.cell.a.row : -1;
+
+	value_release (v);
+	return row;
+}
+
+static void
+test_name_users (void)
+{
+	Workbook *wb = workbook_new ();
+	Sheet *sheet1, *sheet2;
+	GnmNamedExpr *nx, *ny, *nz;
+	GnmParsePos pp;
+	GOUndo *undo = NULL;
+	gboolean ok = TRUE;
+
+	mark_test_start ("test_name_users");
+
+	sheet1 = workbook_sheet_add (wb, -1,
+				     GNM_DEFAULT_COLS, GNM_DEFAULT_ROWS);
+	sheet2 = workbook_sheet_add (wb, -1,
+				     GNM_DEFAULT_COLS, GNM_DEFAULT_ROWS);
+
+	define_name ("NAMEX", "Sheet1!$A$5", sheet2);
+	define_name ("NAMEY", "NAMEX*2", sheet2);
+	define_name ("NAMEZ", "$B$3", wb);
+
+	parse_pos_init_sheet (&pp, sheet2);
+	nx = expr_name_lookup (&pp, "NAMEX");
+	ny = expr_name_lookup (&pp, "NAMEY");
+	nz = expr_name_lookup (&pp, "NAMEZ");
+	g_return_if_fail (nx && ny && nz);
+
+	if (!expr_name_in_use (nx) || expr_name_in_use (ny)) {
+		g_printerr ("Wrong name usage before redefinition\n");
+		ok = FALSE;
+	}
+
+	sheet_insert_rows (sheet1, 0, 2, &undo, NULL);
+	if (test_name_users_row (nx) != 6 || test_name_users_row (nz) != 2) {
+		g_printerr ("Names not relocated properly\n");
+		ok = FALSE;
+	}
+	go_undo_undo (undo);
+	g_object_unref (undo);
+	if (test_name_users_row (nx) != 4 || test_name_users_row (nz) != 2) {
+		g_printerr ("Names not restored properly\n");
+		ok = FALSE;
+	}
+
+	expr_name_set_expr (ny, gnm_expr_top_new_constant (value_new_int (3)));
+	if (expr_name_in_use (nx)) {
+		g_printerr ("Wrong name usage after redefinition\n");
+		ok = FALSE;
+	}
+
+	if (ok)
+		g_printerr ("Name users are consistent.\n");
+
+	g_object_unref (wb);
+
+	mark_test_end ("test_name_users");
+}
+
+static void
+test_sheet_dup (void)
+{
+	Workbook *wb = workbook_new ();
+	Sheet *src, *dst;
+	GnmParsePos pp;
+	GnmExprTop const *te_b, *te_c;
+	GnmExprTop const *dst_b = NULL;
+	GSList *sheets;
+	int r;
+	gboolean ok = TRUE;
+
+	mark_test_start ("test_sheet_dup");
+
+	src = workbook_sheet_add (wb, -1, GNM_DEFAULT_COLS, GNM_DEFAULT_ROWS);
+	parse_pos_init_sheet (&pp, src);
+	te_b = gnm_expr_parse_str ("Sheet1!$A$1+A1", &pp,
+				   GNM_EXPR_PARSE_DEFAULT,
+				   gnm_conventions_default, NULL);
+	te_c = gnm_expr_parse_str ("A1*2", &pp,
+				   GNM_EXPR_PARSE_DEFAULT,
+				   gnm_conventions_default, NULL);
+	for (r = 0; r < 100; r++) {
+		gnm_cell_set_value (sheet_cell_fetch (src, 0, r),
+				    value_new_int (r));
+		gnm_cell_set_expr (sheet_cell_fetch (src, 1, r), te_b);
+		gnm_cell_set_expr (sheet_cell_fetch (src, 2, r), te_c);
+	}
+
+	dst = sheet_dup (src);
+	workbook_sheet_attach (wb, dst);
+
+	for (r = 0; r < 100; r++) {
+		GnmCell const *cb = sheet_cell_get (dst, 1, r);
+		GnmCell const *cc = sheet_cell_get (dst, 2, r);
+
+		if (!cb || !cc) {
+			g_printerr ("Missing cell in row %d\n", r + 1);
+			ok = FALSE;
+			break;
+		}
+		if (dst_b == NULL)
+			dst_b = cb->base.texpr;
+		if (cb->base.texpr != dst_b) {
+			g_printerr ("Expressions not shared in row %d\n", r + 1);
+			ok = FALSE;
+		}
+		if (cc->base.texpr != te_c) {
+			g_printerr ("Unchanged expression copied in row %d\n", r + 1);
+			ok = FALSE;
+		}
+	}
+
+	if (dst_b) {
+		sheets = gnm_expr_top_referenced_sheets (dst_b);
+		if (g_slist_find (sheets, src) || !g_slist_find (sheets, dst)) {
+			g_printerr ("Reference to the source sheet was not relocated\n");
+			ok = FALSE;
+		}
+		g_slist_free (sheets);
+	}
+
+	gnm_expr_top_unref (te_b);
+	gnm_expr_top_unref (te_c);
+
+	if (ok)
+		g_printerr ("Duplicated sheet is consistent.\n");
+
+	g_object_unref (wb);
+
+	mark_test_end ("test_sheet_dup");
+}
+
+static gboolean
+test_dep_compact_check (Sheet *sheet, int col, int r0, int r1, gnm_float x)
+{
+	int r;
+
+	for (r = r0; r < r1; r++) {
+		GnmCell const *cell = sheet_cell_get (sheet, col, r);
+		if (!cell || !cell->value ||
+		    value_get_as_float (cell->value) != x) {
+			g_printerr ("Wrong value in %s\n", cell_coord_name (col, r));
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+static void
+test_dep_compact (void)
+{
+	Workbook *wb = workbook_new ();
+	Sheet *sheet;
+	int r;
+	gboolean ok = TRUE;
+
+	mark_test_start ("test_dep_compact");
+
+	sheet = workbook_sheet_add (wb, -1, GNM_DEFAULT_COLS, GNM_DEFAULT_ROWS);
+
+	define_cell (sheet, 0, 0, "1");
+	define_cell (sheet, 0, 1, "2");
+	define_cell (sheet, 0, 2, "3");
+	for (r = 0; r < 100; r++) {
+		define_cell (sheet, 1, r, "=$A$1*2");
+		define_cell (sheet, 2, r, "=SUM($A$1:$A$3)");
+	}
+	workbook_recalc (wb);
+	workbook_compact_dependencies (wb);
+
+	define_cell (sheet, 0, 0, "10");
+	workbook_recalc (wb);
+	ok = ok && test_dep_compact_check (sheet, 1, 0, 100, 20);
+	ok = ok && test_dep_compact_check (sheet, 2, 0, 100, 15);
+
+	/* Edit the packed graph: remove some dependents, add others.  */
+	for (r = 0; r < 50; r++)
+		define_cell (sheet, 1, r, "7");
+	for (r = 100; r < 110; r++)
+		define_cell (sheet, 1, r, "=$A$1*2");
+
+	define_cell (sheet, 0, 0, "4");
+	workbook_recalc (wb);
+	ok = ok && test_dep_compact_check (sheet, 1, 0, 50, 7);
+	ok = ok && test_dep_compact_check (sheet, 1, 50, 110, 8);
+	ok = ok && test_dep_compact_check (sheet, 2, 0, 100, 9);
+
+	if (ok)
+		g_printerr ("Compacted dependencies are consistent.\n");
+
+	g_object_unref (wb);
+
+	mark_test_end ("test_dep_compact");
+}
+
+/* ------------------------------------------------------------------------- */
+
+#define MAYBE_DO(name) if (strcmp (testname, "all") != 0 && strcmp (testname, (name)) != 0) { } else
+
+int
+main (int argc, char const **argv)
+{
+	GOErrorInfo	*plugin_errs;
+	GOCmdContext	*cc;
+	GOptionContext	*ocontext;
+	GError		*error = NULL;
+	const char *testname;
+
+	/* No code before here, we need to init threads */
+	argv = gnm_pre_parse_init (argc, argv);
+
+	gnm_conf_set_persistence (FALSE);
+
+	ocontext = g_option_context_new (_("[testname]"));
+	g_option_context_add_main_entries (ocontext, sstest_options, GETTEXT_PACKAGE);
+	g_option_context_add_group	  (ocontext, gnm_get_option_group ());
+	g_option_context_parse (ocontext, &argc, (gchar ***)&argv, &error);
+	g_option_context_free (ocontext);
+
+	if (error) {
+		g_printerr (_("%s\nRun '%s --help' to see a full list of available command line options.\n"),
+			    error->message, g_get_prgname ());
+		g_error_free (error);
+		return 1;
+	}
+
+	if (sstest_show_version) {
+		g_printerr (_("version '%s'\ndatadir := '%s'\nlibdir := '%s'\n"),
+			    GNM_VERSION_FULL, gnm_sys_data_dir (), gnm_sys_lib_dir ());
+		return 0;
+	}
+
+	gnm_init ();
+
+	cc = gnm_cmd_context_stderr_new ();
+	gnm_plugins_init (GO_CMD_CONTEXT (cc));
+	go_plugin_db_activate_plugin_list (
+		go_plugins_get_available_plugins (), &plugin_errs);
+	if (plugin_errs) {
+		/* FIXME: What do we want to do here? */
+		go_error_info_free (plugin_errs);
+	}
+
+	if (func_state_file) {
+		function_dump_defs (func_state_file, 0);
+		goto done;
+	}
+	if (func_def_file) {
+		function_dump_defs (func_def_file, 1);
+		goto done;
+	}
+	if (ext_refs_file) {
+		function_dump_defs (ext_refs_file, 4);
+		goto done;
+	}
+	if (samples_file) {
+		function_dump_defs (samples_file, 5);
+		goto done;
+	}
+
+	testname = argv[1];
+	if (!testname) testname = "all";
+
+	/* ---------------------------------------- */
+
+	MAYBE_DO ("test_insdel_rowcol_names") test_insdel_rowcol_names ();
+	MAYBE_DO ("test_insert_delete") test_insert_delete ();
+	MAYBE_DO ("test_func_help") test_func_help ();
+	MAYBE_DO ("test_nonascii_numbers") test_nonascii_numbers ();
+	MAYBE_DO ("test_random") test_random ();
+	MAYBE_DO ("test_rangefunc") {
+		int max_exp = (argc > 2 && strcmp (testname, "all") != 0)
+			? (int)g_ascii_strtoll (argv[2], NULL, 10)
+			: 6;
+		test_rangefunc (max_exp);
+	}
+	MAYBE_DO ("test_expr_program") test_expr_program ();
+	MAYBE_DO ("test_func_memo") test_func_memo ();
+	MAYBE_DO ("test_vector_funcs") test_vector_funcs ();
+	MAYBE_DO ("test_sort") test_sort ();
+	MAYBE_DO ("test_relocate") test_relocate ();
+	MAYBE_DO ("test_paste") test_paste ();
+	MAYBE_DO ("test_autofill") test_autofill ();
+	MAYBE_DO ("test_filter") test_filter ();
+	MAYBE_DO ("test_merge") test_merge ();
+	MAYBE_DO ("test_name_users") test_name_users ();
+	MAYBE_DO ("test_sheet_dup") test_sheet_dup ();
+	MAYBE_DO ("test_dep_compact") test_dep_compact ();
+	if (argc > 2) {
+		MAYBE_DO ("test_recalc") {
+			char *url = go_shell_arg_to_uri (argv[2]);
+			test_recalc (cc, url);
+			g_free (url);
+		}
+		MAYBE_DO ("test_render") {
+			char *url = go_shell_arg_to_uri (argv[2]);
+			test_render (cc, url, argv[3]);
 			g_free (url);
 		}
 	}
@@ -877,7 +877,7 @@ stf_parse_general (StfParseOptions_t *parseoptions,
 	while (*src.position != '\0' && src.position < data_end) {
 		GPtrArray *line;
 
-		if (row == GNM_MAX_ROWS) {
+		if (row == gnm_sheet_max_rows_limit ()) {
 			parseoptions->rows_exceeded = TRUE;
 			break;
 		}
@@ -1553,22 +1553,13 @@ gnm_string_cmp (gconstpointer gstr_a, gconstpointer gstr_b)
 static int
 gnm_string_cmp_ignorecase (gconstpointer gstr_a, gconstpointer gstr_b)
 {
-	gchar *a;
-	gchar *b;
-	int res;
-
 	if (gstr_a == gstr_b)
 		return 0;
 
-	a = g_utf8_casefold (((GOString const *)gstr_a)->str, -1);
-	b = g_utf8_casefold (((GOString const *)gstr_b)->str, -1);
-
-	res = g_utf8_collate (a, b);
-
-	g_free (a);
-	g_free (b);
-
-	return res;
+	/* Case folding does not depend on the locale, so use the folded
+	 * strings cached on the GOStrings.  */
+	return g_utf8_collate (go_string_get_casefold (gstr_a),
+			       go_string_get_casefold (gstr_b));
 }
 
 
@@ -2226,6 +2226,9 @@ cb_workbook_debug_info (WBCGtk *wbcg)
 	if (gnm_debug_flag ("notebook-size"))
 		dump_size_tree (GTK_WIDGET (wbcg_toplevel (wbcg)), GINT_TO_POINTER (0));
 
+	if (gnm_debug_flag ("deps-compact"))
+		workbook_compact_dependencies (wb);
+
 	if (gnm_debug_flag ("deps")) {
 		dependents_dump (wb);
 	}
@@ -2813,7 +2816,8 @@ wbc_gtk_create_edit_area (WBCGtk *wbcg)
 	/* Set a reasonable width for the selection box. */
 	len = gnm_widget_measure_string
 		(GTK_WIDGET (wbcg_toplevel (wbcg)),
-		 cell_coord_name (GNM_MAX_COLS - 1, GNM_MAX_ROWS - 1));
+		 cell_coord_name (GNM_MAX_COLS - 1,
+				  gnm_sheet_max_rows_limit () - 1));
 	/*
 	 * Add a little extra since font might be proportional and since
 	 * we also put user defined names there.
@@ -1394,6 +1394,7 @@ workbook_view_new_from_input (GsfInput *input,
 		} else {
 			workbook_share_expressions (new_wb, TRUE);
 			workbook_optimize_style (new_wb);
+			workbook_compact_dependencies (new_wb);
 			workbook_queue_volatile_recalc (new_wb);
 			workbook_recalc (new_wb);
 			workbook_update_graphs (new_wb);
@@ -705,6 +705,14 @@ workbook_optimize_style (Workbook *wb)
 	});
 }
 
+void
+workbook_compact_dependencies (Workbook *wb)
+{
+	WORKBOOK_FOREACH_SHEET (wb, sheet, {
+		gnm_dep_container_compact (sheet->deps);
+	});
+}
+
 /**
  * workbook_foreach_name:
  * @wb: #Workbook
@@ -1422,13 +1430,14 @@ workbook_set_1904 (Workbook *wb, gboolean base1904)
 GnmSheetSize const *
 workbook_get_sheet_size (Workbook const *wb)
 {
-	static const GnmSheetSize max_size = {
-		GNM_MAX_COLS, GNM_MAX_ROWS
-	};
+	static GnmSheetSize max_size;
 	int n = wb ? workbook_sheet_count (wb) : 0;
 
-	if (n == 0)
+	if (n == 0) {
+		max_size.max_cols = GNM_MAX_COLS;
+		max_size.max_rows = gnm_sheet_max_rows_limit ();
 		return &max_size;
+	}
 
 	if (!wb->sheet_size_cached) {
 		Workbook *wb1 = (Workbook *)wb;
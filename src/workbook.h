@@ -43,6 +43,7 @@ unsigned    workbook_find_command	(Workbook *wb,
 
 GnmExprSharer *workbook_share_expressions (Workbook *wb, gboolean freeit);
 void        workbook_optimize_style     (Workbook *wb);
+void        workbook_compact_dependencies (Workbook *wb);
 
 void        workbook_update_graphs      (Workbook *wb);
 
@@ -1983,7 +1983,7 @@ xml_sax_cell (GsfXMLIn *xin, xmlChar const **attrs)
 
 	XML_CHECK2 (col >= 0 && col <= GNM_MAX_COLS - MAX (1, cols),
 		    go_format_unref (value_fmt));
-	XML_CHECK2 (row >= 0 && row <= GNM_MAX_ROWS - MAX (1, rows),
+	XML_CHECK2 (row >= 0 && row <= gnm_sheet_max_rows_limit () - MAX (1, rows),
 		    go_format_unref (value_fmt));
 
 	if (cols > 0 || rows > 0) {
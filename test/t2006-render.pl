@@ -0,0 +1,42 @@
+#!/usr/bin/perl -w
+# -----------------------------------------------------------------------------
+
+use strict;
+use lib ($0 =~ m|^(.*/)| ? $1 : ".");
+use GnumericTest;
+
+&message ("Check headless rendering.");
+
+my @sources = ("$samples/format-tests.gnumeric",
+	       "$samples/sheet-formatting-tests.gnumeric",
+	       "$samples/border.xls");
+
+my $ngood = 0;
+my $nbad = 0;
+
+foreach my $src (@sources) {
+    next unless -r $src;
+
+    print STDERR "Rendering $src\n";
+
+    my $cmd = &GnumericTest::quotearg ($sstest, 'test_render', $src);
+    my $actual = `$cmd 2>&1`;
+    my $err = $?;
+
+    if (!$err && $actual =~ /^  draw at 100%: [0-9.]+s$/m) {
+	$ngood++;
+    } else {
+	foreach (split ("\n", $actual)) {
+	    print "| $_\n";
+	}
+	$nbad++;
+    }
+}
+
+&GnumericTest::report_skip ("No source files present") if $nbad + $ngood == 0;
+
+if ($nbad > 0) {
+    die "Fail\n";
+} else {
+    print STDERR "Pass\n";
+}
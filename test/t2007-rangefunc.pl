@@ -0,0 +1,9 @@
+#!/usr/bin/perl -w
+# -----------------------------------------------------------------------------
+
+use strict;
+use lib ($0 =~ m|^(.*/)| ? $1 : ".");
+use GnumericTest;
+
+&message ("Checking accuracy of range reductions.");
+&sstest ("test_rangefunc", sub { /All errors within bounds\./ } );
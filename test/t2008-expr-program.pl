@@ -0,0 +1,9 @@
+#!/usr/bin/perl -w
+# -----------------------------------------------------------------------------
+
+use strict;
+use lib ($0 =~ m|^(.*/)| ? $1 : ".");
+use GnumericTest;
+
+&message ("Checking compiled expression programs.");
+&sstest ("test_expr_program", sub { /All results agree with the tree evaluator\./ } );
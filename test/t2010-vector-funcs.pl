@@ -0,0 +1,9 @@
+#!/usr/bin/perl -w
+# -----------------------------------------------------------------------------
+
+use strict;
+use lib ($0 =~ m|^(.*/)| ? $1 : ".");
+use GnumericTest;
+
+&message ("Checking vectorized evaluation of array arguments.");
+&sstest ("test_vector_funcs", sub { /Vector results are consistent\./ } );
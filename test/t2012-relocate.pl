@@ -0,0 +1,9 @@
+#!/usr/bin/perl -w
+# -----------------------------------------------------------------------------
+
+use strict;
+use lib ($0 =~ m|^(.*/)| ? $1 : ".");
+use GnumericTest;
+
+&message ("Checking expression relocation on row insertion.");
+&sstest ("test_relocate", sub { /Relocated expressions are consistent\./ } );
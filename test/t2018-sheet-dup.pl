@@ -0,0 +1,9 @@
+#!/usr/bin/perl -w
+# -----------------------------------------------------------------------------
+
+use strict;
+use lib ($0 =~ m|^(.*/)| ? $1 : ".");
+use GnumericTest;
+
+&message ("Checking sheet duplication.");
+&sstest ("test_sheet_dup", sub { /Duplicated sheet is consistent\./ } );
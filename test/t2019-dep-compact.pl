@@ -0,0 +1,9 @@
+#!/usr/bin/perl -w
+# -----------------------------------------------------------------------------
+
+use strict;
+use lib ($0 =~ m|^(.*/)| ? $1 : ".");
+use GnumericTest;
+
+&message ("Checking compaction of dependencies.");
+&sstest ("test_dep_compact", sub { /Compacted dependencies are consistent\./ } );
@@ -54,6 +54,9 @@ my $nbad = 0;
 &message ("Checking ssgrep -w.");
 &check ("$ssgrep -h -i -w COUNT $src1 $src2 $src3", 'TEST9A', 0);
 
+&message ("Checking ssgrep -F.");
+&check ("$ssgrep -h -i -F SUMIF $src1 $src2 $src3", 'TEST10A', 0);
+
 # -----------------------------------------------------------------------------
 
 if ($nbad > 0) {
@@ -181,4 +184,9 @@ COUNT
 =count(A14:A17)
 =count(G14:G17)
 =count(B14:B18)
+*** TEST10A ***
+SUMIF
+=sumif(A14:A17,H14)
+=sumif(B14:B17,H15)
+=sumif(A14:A17,H15,C14:C17)
 *** END ***